@@ -24,16 +24,57 @@ SQLGetInfo
 SQLSetStmtAttr
 SQLGetStmtAttr
 SQLExecDirect
+SQLPrepare
+SQLExecute
+SQLParamData
+SQLPutData
+SQLSetPos
+SQLBulkOperations
 SQLRowCount
+SQLMoreResults
+SQLEndTran
 
 ndbc Extensions:
-JsonDescribe - Inspects a completed statement's result set and returns a formatting string that
+JsonDescribe - Inspects a completed statement's result set and returns a native row descriptor that
                can be used to export data with JsonData.
+               DECIMAL and NUMERIC columns can optionally be output exactly, as numbers, strings or scaled integers.
+               Dates and times are formatted natively as ISO-8601 text, or optionally as epoch milliseconds.
+               GUIDs are bound natively and formatted in their canonical form.
+               A subset of the columns can be selected, so the rest are never bound or fetched.
 JsonHeader - Returns a string containing the header of a JSON-formatted result set.
              The result set takes the form of a 2-dimensional array, with the first row containing the column headers.
 JsonData - Returns one or more rows from a completed result set.
            Requires a row formatting string like that provided by JsonDescribe.
+           The output can be capped in length, holding back the row that would overflow it for the next call.
 JsonTrailer - Returns the character string required to close out the result set (thus far, "]").
+JsonDataBudget - Returns rows like JsonData, sizing each batch to fit a time and/or output length budget
+                 from the statement's observed per-row cost.
+JsonMetadata - Returns the name, type, size, precision, scale and nullability of each column of a result set.
+               Collected once per result set and cached on the statement.
+JsonDataScroll - Returns rows like JsonData, starting from an absolute or relative position in a scrollable result set.
+JsonColumnData - Returns one or more rows from a completed result set as an array of columns.
+                 Low-cardinality text columns can be dictionary-encoded so each distinct value is output once.
+BindParameters - Binds an array of javascript values as a statement's input parameters, with matching SQL types.
+BindDataAtExec - Binds a parameter whose value is sent in parts while the query runs, with SQLPutData or PutStream.
+ExecBatch - Runs a prepared query for each of an array of rows, sending the rows in batches of parameter arrays.
+            Returns the status of each row.
+ExecColumns - Runs a prepared query for each row of a set of typed array columns, binding the arrays' memory directly.
+              Nulls are given as bitmaps.
+BindRowset - Binds an array of rows as a cursor's rowset, for SQLBulkOperations or SQLSetPos to write.
+RowStatus - Returns the status of each row of a bound rowset.
+BulkWrite - Inserts, updates or deletes an array of rows in batches, with SQLBulkOperations where the driver supports it
+            and key-matched parameter arrays otherwise.
+CachedExecute - Executes a query on a statement prepared for the same text by an earlier call on the connection.
+                Prepared statements are kept in a least recently used cache on each connection.
+StatementCache - Sets the capacity of a connection's statement cache and returns its hit, miss and eviction counts.
+BulkLoad - Loads a CSV or NDJSON file with batched inserts, reading and parsing it natively on a worker thread.
+           Optionally commits at a fixed row interval.
+PutStream - Sends the contents of a readable stream as the value of a data-at-execution parameter, one chunk at a time
+            on worker threads.
+GroupCommit - Turns on group commit, where concurrent writes on a connection share one transaction committed once per
+              interval.  Returns the group commit settings and counters.
+AwaitCommit - Calls back once the writes made so far on a connection in group commit mode are committed.
+CallProcedure - Calls a stored procedure, returning its result sets and output parameters together.
 
 Change History
 Date        Author                Description
@@ -53,8 +94,14 @@ determine whether a child process can connect to a database at all.
 /* Include node.js API.
  */
 #include <node.h>
+#include <node_buffer.h>
 #include <v8.h>
 
+/* Include C library file input and character classes, used by bulk loads.
+ */
+#include <ctype.h>
+#include <stdio.h>
+
 /* Windows include for windows environments.
  */
 #if defined (__WIN32__)
@@ -83,6 +130,7 @@ using namespace v8;
 #define ndbcSQL_AD_CONSTRAINT_NAME_DEFINITION String::NewSymbol("SQL_AD_CONSTRAINT_NAME_DEFINITION")
 #define ndbcSQL_AD_DROP_DOMAIN_CONSTRAINT String::NewSymbol("SQL_AD_DROP_DOMAIN_CONSTRAINT")
 #define ndbcSQL_AD_DROP_DOMAIN_DEFAULT String::NewSymbol("SQL_AD_DROP_DOMAIN_DEFAULT")
+#define ndbcSQL_ADD String::NewSymbol("SQL_ADD")
 #define ndbcSQL_AF_ALL String::NewSymbol("SQL_AF_ALL")
 #define ndbcSQL_AF_AVG String::NewSymbol("SQL_AF_AVG")
 #define ndbcSQL_AF_COUNT String::NewSymbol("SQL_AF_COUNT")
@@ -175,7 +223,10 @@ using namespace v8;
 #define ndbcSQL_AUTOCOMMIT_ON String::NewSymbol("SQL_AUTOCOMMIT_ON")
 #define ndbcSQL_BATCH_ROW_COUNT String::NewSymbol("SQL_BATCH_ROW_COUNT")
 #define ndbcSQL_BATCH_SUPPORT String::NewSymbol("SQL_BATCH_SUPPORT")
+#define ndbcSQL_BIGINT String::NewSymbol("SQL_BIGINT")
+#define ndbcSQL_BINARY String::NewSymbol("SQL_BINARY")
 #define ndbcSQL_BIND_BY_COLUMN String::NewSymbol("SQL_BIND_BY_COLUMN")
+#define ndbcSQL_BIT String::NewSymbol("SQL_BIT")
 #define ndbcSQL_BOOKMARK_PERSISTENCE String::NewSymbol("SQL_BOOKMARK_PERSISTENCE")
 #define ndbcSQL_BP_CLOSE String::NewSymbol("SQL_BP_CLOSE")
 #define ndbcSQL_BP_DELETE String::NewSymbol("SQL_BP_DELETE")
@@ -256,6 +307,7 @@ using namespace v8;
 #define ndbcSQL_CDO_CONSTRAINT_NON_DEFERRABLE String::NewSymbol("SQL_CDO_CONSTRAINT_NON_DEFERRABLE")
 #define ndbcSQL_CDO_CREATE_DOMAIN String::NewSymbol("SQL_CDO_CREATE_DOMAIN")
 #define ndbcSQL_CDO_DEFAULT String::NewSymbol("SQL_CDO_DEFAULT")
+#define ndbcSQL_CHAR String::NewSymbol("SQL_CHAR")
 #define ndbcSQL_CL_END String::NewSymbol("SQL_CL_END")
 #define ndbcSQL_CL_NOT_SUPPORTED String::NewSymbol("SQL_CL_NOT_SUPPORTED")
 #define ndbcSQL_CL_START String::NewSymbol("SQL_CL_START")
@@ -264,6 +316,7 @@ using namespace v8;
 #define ndbcSQL_CN_NONE String::NewSymbol("SQL_CN_NONE")
 #define ndbcSQL_COLLATION_SEQ String::NewSymbol("SQL_COLLATION_SEQ")
 #define ndbcSQL_COLUMN_ALIAS String::NewSymbol("SQL_COLUMN_ALIAS")
+#define ndbcSQL_COMMIT String::NewSymbol("SQL_COMMIT")
 #define ndbcSQL_CONCAT_NULL_BEHAVIOR String::NewSymbol("SQL_CONCAT_NULL_BEHAVIOR")
 #define ndbcSQL_CONCUR_LOCK String::NewSymbol("SQL_CONCUR_LOCK")
 #define ndbcSQL_CONCUR_READ_ONLY String::NewSymbol("SQL_CONCUR_READ_ONLY")
@@ -379,7 +432,10 @@ using namespace v8;
 #define ndbcSQL_DD_DROP_DOMAIN String::NewSymbol("SQL_DD_DROP_DOMAIN")
 #define ndbcSQL_DD_RESTRICT String::NewSymbol("SQL_DD_RESTRICT")
 #define ndbcSQL_DDL_INDEX String::NewSymbol("SQL_DDL_INDEX")
+#define ndbcSQL_DECIMAL String::NewSymbol("SQL_DECIMAL")
 #define ndbcSQL_DEFAULT_TXN_ISOLATION String::NewSymbol("SQL_DEFAULT_TXN_ISOLATION")
+#define ndbcSQL_DELETE String::NewSymbol("SQL_DELETE")
+#define ndbcSQL_DELETE_BY_BOOKMARK String::NewSymbol("SQL_DELETE_BY_BOOKMARK")
 #define ndbcSQL_DESCRIBE_PARAMETER String::NewSymbol("SQL_DESCRIBE_PARAMETER")
 #define ndbcSQL_DI_CREATE_INDEX String::NewSymbol("SQL_DI_CREATE_INDEX")
 #define ndbcSQL_DI_DROP_INDEX String::NewSymbol("SQL_DI_DROP_INDEX")
@@ -400,6 +456,7 @@ using namespace v8;
 #define ndbcSQL_DL_SQL92_TIME String::NewSymbol("SQL_DL_SQL92_TIME")
 #define ndbcSQL_DL_SQL92_TIMESTAMP String::NewSymbol("SQL_DL_SQL92_TIMESTAMP")
 #define ndbcSQL_DM_VER String::NewSymbol("SQL_DM_VER")
+#define ndbcSQL_DOUBLE String::NewSymbol("SQL_DOUBLE")
 #define ndbcSQL_DRIVER_HDBC String::NewSymbol("SQL_DRIVER_HDBC")
 #define ndbcSQL_DRIVER_HDESC String::NewSymbol("SQL_DRIVER_HDESC")
 #define ndbcSQL_DRIVER_HENV String::NewSymbol("SQL_DRIVER_HENV")
@@ -432,10 +489,18 @@ using namespace v8;
 #define ndbcSQL_ERROR String::NewSymbol("SQL_ERROR")
 #define ndbcSQL_EXPRESSIONS_IN_ORDERBY String::NewSymbol("SQL_EXPRESSIONS_IN_ORDERBY")
 #define ndbcSQL_FALSE String::NewSymbol("SQL_FALSE")
+#define ndbcSQL_FETCH_ABSOLUTE String::NewSymbol("SQL_FETCH_ABSOLUTE")
+#define ndbcSQL_FETCH_BY_BOOKMARK String::NewSymbol("SQL_FETCH_BY_BOOKMARK")
+#define ndbcSQL_FETCH_FIRST String::NewSymbol("SQL_FETCH_FIRST")
+#define ndbcSQL_FETCH_LAST String::NewSymbol("SQL_FETCH_LAST")
+#define ndbcSQL_FETCH_NEXT String::NewSymbol("SQL_FETCH_NEXT")
+#define ndbcSQL_FETCH_PRIOR String::NewSymbol("SQL_FETCH_PRIOR")
+#define ndbcSQL_FETCH_RELATIVE String::NewSymbol("SQL_FETCH_RELATIVE")
 #define ndbcSQL_FILE_CATALOG String::NewSymbol("SQL_FILE_CATALOG")
 #define ndbcSQL_FILE_NOT_SUPPORTED String::NewSymbol("SQL_FILE_NOT_SUPPORTED")
 #define ndbcSQL_FILE_TABLE String::NewSymbol("SQL_FILE_TABLE")
 #define ndbcSQL_FILE_USAGE String::NewSymbol("SQL_FILE_USAGE")
+#define ndbcSQL_FLOAT String::NewSymbol("SQL_FLOAT")
 #define ndbcSQL_FN_CVT_CAST String::NewSymbol("SQL_FN_CVT_CAST")
 #define ndbcSQL_FN_CVT_CONVERT String::NewSymbol("SQL_FN_CVT_CONVERT")
 #define ndbcSQL_FN_NUM_ABS String::NewSymbol("SQL_FN_NUM_ABS")
@@ -533,6 +598,7 @@ using namespace v8;
 #define ndbcSQL_GD_OUTPUT_PARAMS String::NewSymbol("SQL_GD_OUTPUT_PARAMS")
 #define ndbcSQL_GETDATA_EXTENSIONS String::NewSymbol("SQL_GETDATA_EXTENSIONS")
 #define ndbcSQL_GROUP_BY String::NewSymbol("SQL_GROUP_BY")
+#define ndbcSQL_GUID String::NewSymbol("SQL_GUID")
 #define ndbcSQL_HANDLE_DBC String::NewSymbol("SQL_HANDLE_DBC")
 #define ndbcSQL_HANDLE_DESC String::NewSymbol("SQL_HANDLE_DESC")
 #define ndbcSQL_HANDLE_ENV String::NewSymbol("SQL_HANDLE_ENV")
@@ -551,6 +617,7 @@ using namespace v8;
 #define ndbcSQL_INFO_SCHEMA_VIEWS String::NewSymbol("SQL_INFO_SCHEMA_VIEWS")
 #define ndbcSQL_INSENSITIVE String::NewSymbol("SQL_INSENSITIVE")
 #define ndbcSQL_INSERT_STATEMENT String::NewSymbol("SQL_INSERT_STATEMENT")
+#define ndbcSQL_INTEGER String::NewSymbol("SQL_INTEGER")
 #define ndbcSQL_INTEGRITY String::NewSymbol("SQL_INTEGRITY")
 #define ndbcSQL_INVALID_HANDLE String::NewSymbol("SQL_INVALID_HANDLE")
 #define ndbcSQL_IS_INSERT_LITERALS String::NewSymbol("SQL_IS_INSERT_LITERALS")
@@ -583,6 +650,11 @@ using namespace v8;
 #define ndbcSQL_KEYSET_CURSOR_ATTRIBUTES2 String::NewSymbol("SQL_KEYSET_CURSOR_ATTRIBUTES2")
 #define ndbcSQL_KEYWORDS String::NewSymbol("SQL_KEYWORDS")
 #define ndbcSQL_LIKE_ESCAPE_CLAUSE String::NewSymbol("SQL_LIKE_ESCAPE_CLAUSE")
+#define ndbcSQL_LOCK_EXCLUSIVE String::NewSymbol("SQL_LOCK_EXCLUSIVE")
+#define ndbcSQL_LOCK_NO_CHANGE String::NewSymbol("SQL_LOCK_NO_CHANGE")
+#define ndbcSQL_LOCK_UNLOCK String::NewSymbol("SQL_LOCK_UNLOCK")
+#define ndbcSQL_LONGVARBINARY String::NewSymbol("SQL_LONGVARBINARY")
+#define ndbcSQL_LONGVARCHAR String::NewSymbol("SQL_LONGVARCHAR")
 #define ndbcSQL_MAX_ASYNC_CONCURRENT_STATEMENTS String::NewSymbol("SQL_MAX_ASYNC_CONCURRENT_STATEMENTS")
 #define ndbcSQL_MAX_BINARY_LITERAL_LEN String::NewSymbol("SQL_MAX_BINARY_LITERAL_LEN")
 #define ndbcSQL_MAX_CATALOG_NAME_LEN String::NewSymbol("SQL_MAX_CATALOG_NAME_LEN")
@@ -624,6 +696,7 @@ using namespace v8;
 #define ndbcSQL_NOSCAN_OFF String::NewSymbol("SQL_NOSCAN_OFF")
 #define ndbcSQL_NOSCAN_ON String::NewSymbol("SQL_NOSCAN_ON")
 #define ndbcSQL_NULL_COLLATION String::NewSymbol("SQL_NULL_COLLATION")
+#define ndbcSQL_NUMERIC String::NewSymbol("SQL_NUMERIC")
 #define ndbcSQL_NUMERIC_FUNCTIONS String::NewSymbol("SQL_NUMERIC_FUNCTIONS")
 #define ndbcSQL_ODBC_INTERFACE_CONFORMANCE String::NewSymbol("SQL_ODBC_INTERFACE_CONFORMANCE")
 #define ndbcSQL_ODBC_VER String::NewSymbol("SQL_ODBC_VER")
@@ -651,6 +724,9 @@ using namespace v8;
 #define ndbcSQL_PARAM_DIAG_UNAVAILABLE String::NewSymbol("SQL_PARAM_DIAG_UNAVAILABLE")
 #define ndbcSQL_PARAM_ERROR String::NewSymbol("SQL_PARAM_ERROR")
 #define ndbcSQL_PARAM_IGNORE String::NewSymbol("SQL_PARAM_IGNORE")
+#define ndbcSQL_PARAM_INPUT String::NewSymbol("SQL_PARAM_INPUT")
+#define ndbcSQL_PARAM_INPUT_OUTPUT String::NewSymbol("SQL_PARAM_INPUT_OUTPUT")
+#define ndbcSQL_PARAM_OUTPUT String::NewSymbol("SQL_PARAM_OUTPUT")
 #define ndbcSQL_PARAM_PROCEED String::NewSymbol("SQL_PARAM_PROCEED")
 #define ndbcSQL_PARAM_SUCCESS String::NewSymbol("SQL_PARAM_SUCCESS")
 #define ndbcSQL_PARAM_SUCCESS_WITH_INFO String::NewSymbol("SQL_PARAM_SUCCESS_WITH_INFO")
@@ -666,13 +742,24 @@ using namespace v8;
 #define ndbcSQL_POS_POSITION String::NewSymbol("SQL_POS_POSITION")
 #define ndbcSQL_POS_REFRESH String::NewSymbol("SQL_POS_REFRESH")
 #define ndbcSQL_POS_UPDATE String::NewSymbol("SQL_POS_UPDATE")
+#define ndbcSQL_POSITION String::NewSymbol("SQL_POSITION")
 #define ndbcSQL_PROCEDURE_TERM String::NewSymbol("SQL_PROCEDURE_TERM")
 #define ndbcSQL_PROCEDURES String::NewSymbol("SQL_PROCEDURES")
 #define ndbcSQL_QUOTED_IDENTIFIER_CASE String::NewSymbol("SQL_QUOTED_IDENTIFIER_CASE")
 #define ndbcSQL_RD_OFF String::NewSymbol("SQL_RD_OFF")
 #define ndbcSQL_RD_ON String::NewSymbol("SQL_RD_ON")
+#define ndbcSQL_REAL String::NewSymbol("SQL_REAL")
+#define ndbcSQL_REFRESH String::NewSymbol("SQL_REFRESH")
+#define ndbcSQL_ROLLBACK String::NewSymbol("SQL_ROLLBACK")
+#define ndbcSQL_ROW_ADDED String::NewSymbol("SQL_ROW_ADDED")
+#define ndbcSQL_ROW_DELETED String::NewSymbol("SQL_ROW_DELETED")
+#define ndbcSQL_ROW_ERROR String::NewSymbol("SQL_ROW_ERROR")
 #define ndbcSQL_ROW_IGNORE String::NewSymbol("SQL_ROW_IGNORE")
+#define ndbcSQL_ROW_NOROW String::NewSymbol("SQL_ROW_NOROW")
 #define ndbcSQL_ROW_PROCEED String::NewSymbol("SQL_ROW_PROCEED")
+#define ndbcSQL_ROW_SUCCESS String::NewSymbol("SQL_ROW_SUCCESS")
+#define ndbcSQL_ROW_SUCCESS_WITH_INFO String::NewSymbol("SQL_ROW_SUCCESS_WITH_INFO")
+#define ndbcSQL_ROW_UPDATED String::NewSymbol("SQL_ROW_UPDATED")
 #define ndbcSQL_ROW_UPDATES String::NewSymbol("SQL_ROW_UPDATES")
 #define ndbcSQL_SC_FIPS127_2_TRANSITIONAL String::NewSymbol("SQL_SC_FIPS127_2_TRANSITIONAL")
 #define ndbcSQL_SC_NON_UNIQUE String::NewSymbol("SQL_SC_NON_UNIQUE")
@@ -714,6 +801,7 @@ using namespace v8;
 #define ndbcSQL_SG_USAGE_ON_DOMAIN String::NewSymbol("SQL_SG_USAGE_ON_DOMAIN")
 #define ndbcSQL_SG_USAGE_ON_TRANSLATION String::NewSymbol("SQL_SG_USAGE_ON_TRANSLATION")
 #define ndbcSQL_SG_WITH_GRANT_OPTION String::NewSymbol("SQL_SG_WITH_GRANT_OPTION")
+#define ndbcSQL_SMALLINT String::NewSymbol("SQL_SMALLINT")
 #define ndbcSQL_SNVF_BIT_LENGTH String::NewSymbol("SQL_SNVF_BIT_LENGTH")
 #define ndbcSQL_SNVF_CHAR_LENGTH String::NewSymbol("SQL_SNVF_CHAR_LENGTH")
 #define ndbcSQL_SNVF_CHARACTER_LENGTH String::NewSymbol("SQL_SNVF_CHARACTER_LENGTH")
@@ -820,6 +908,7 @@ using namespace v8;
 #define ndbcSQL_TIMEDATE_ADD_INTERVALS String::NewSymbol("SQL_TIMEDATE_ADD_INTERVALS")
 #define ndbcSQL_TIMEDATE_DIFF_INTERVALS String::NewSymbol("SQL_TIMEDATE_DIFF_INTERVALS")
 #define ndbcSQL_TIMEDATE_FUNCTIONS String::NewSymbol("SQL_TIMEDATE_FUNCTIONS")
+#define ndbcSQL_TINYINT String::NewSymbol("SQL_TINYINT")
 #define ndbcSQL_TRUE String::NewSymbol("SQL_TRUE")
 #define ndbcSQL_TXN_CAPABLE String::NewSymbol("SQL_TXN_CAPABLE")
 #define ndbcSQL_TXN_ISOLATION_OPTION String::NewSymbol("SQL_TXN_ISOLATION_OPTION")
@@ -827,13 +916,24 @@ using namespace v8;
 #define ndbcSQL_TXN_READ_UNCOMMITTED String::NewSymbol("SQL_TXN_READ_UNCOMMITTED")
 #define ndbcSQL_TXN_REPEATABLE_READ String::NewSymbol("SQL_TXN_REPEATABLE_READ")
 #define ndbcSQL_TXN_SERIALIZABLE String::NewSymbol("SQL_TXN_SERIALIZABLE")
+#define ndbcSQL_TYPE_DATE String::NewSymbol("SQL_TYPE_DATE")
+#define ndbcSQL_TYPE_TIME String::NewSymbol("SQL_TYPE_TIME")
+#define ndbcSQL_TYPE_TIMESTAMP String::NewSymbol("SQL_TYPE_TIMESTAMP")
 #define ndbcSQL_U_UNION String::NewSymbol("SQL_U_UNION")
 #define ndbcSQL_U_UNION_ALL String::NewSymbol("SQL_U_UNION_ALL")
 #define ndbcSQL_UB_OFF String::NewSymbol("SQL_UB_OFF")
 #define ndbcSQL_UB_VARIABLE String::NewSymbol("SQL_UB_VARIABLE")
 #define ndbcSQL_UNION String::NewSymbol("SQL_UNION")
+#define ndbcSQL_UNKNOWN_TYPE String::NewSymbol("SQL_UNKNOWN_TYPE")
 #define ndbcSQL_UNSPECIFIED String::NewSymbol("SQL_UNSPECIFIED")
+#define ndbcSQL_UPDATE String::NewSymbol("SQL_UPDATE")
+#define ndbcSQL_UPDATE_BY_BOOKMARK String::NewSymbol("SQL_UPDATE_BY_BOOKMARK")
 #define ndbcSQL_USER_NAME String::NewSymbol("SQL_USER_NAME")
+#define ndbcSQL_VARBINARY String::NewSymbol("SQL_VARBINARY")
+#define ndbcSQL_VARCHAR String::NewSymbol("SQL_VARCHAR")
+#define ndbcSQL_WCHAR String::NewSymbol("SQL_WCHAR")
+#define ndbcSQL_WLONGVARCHAR String::NewSymbol("SQL_WLONGVARCHAR")
+#define ndbcSQL_WVARCHAR String::NewSymbol("SQL_WVARCHAR")
 #define ndbcSQL_XOPEN_CLI_YEAR String::NewSymbol("SQL_XOPEN_CLI_YEAR")
 
 /* String representations of ndbc specific constants.
@@ -842,6 +942,614 @@ using namespace v8;
 #define ndbcINVALID_RETURN String::NewSymbol("INVALID_RETURN")
 #define ndbcINTERNAL_ERROR String::NewSymbol("INTERNAL_ERROR")
 
+/* String representations of ndbc option names and values.
+ */
+#define ndbcCOLUMNS String::NewSymbol("columns")
+#define ndbcDATETIME String::NewSymbol("datetime")
+#define ndbcDECIMAL String::NewSymbol("decimal")
+#define ndbcEPOCH String::NewSymbol("epoch")
+#define ndbcGUID String::NewSymbol("guid")
+#define ndbcISO String::NewSymbol("iso")
+#define ndbcNUMBER String::NewSymbol("number")
+#define ndbcPAIR String::NewSymbol("pair")
+#define ndbcSCALED String::NewSymbol("scaled")
+#define ndbcSTRING String::NewSymbol("string")
+#define ndbcTEXT String::NewSymbol("text")
+
+/* ndbc internal variable ndbcMaxLength
+ * The largest column buffer or record length handled, which is the largest length an SQLLEN can hold.
+ */
+const size_t ndbcMaxLength = (size_t) (((SQLULEN) -1) >> 1);
+
+/* ndbc internal variable ndbcMaxString
+ * The longest string V8 can create.  Longer output can not be returned, so fetch calls stop short of it.
+ */
+const size_t ndbcMaxString = (1 << 28) - 16;
+
+/* ndbc internal function ndbcAddSize
+ * Adds <more> bytes to the length in total.
+ * Returns false, leaving total unchanged, if the sum does not fit in a size_t.
+ */
+bool ndbcAddSize(size_t* total, size_t more) {
+  if (more > ((size_t) -1) - *total) {
+    return false;
+  }
+  *total += more;
+  return true;
+}
+
+/* ndbc internal type ndbcChunk
+ * One block of memory in an ndbcArena.
+ * next - The following chunk, or NULL for the last chunk.
+ * len - The number of bytes in use.
+ * size - The number of bytes available in data.
+ * data - The chunk contents, allocated together with the chunk header.
+ */
+typedef struct ndbcChunk {
+  struct ndbcChunk* next;
+  size_t len;
+  size_t size;
+  char data[1];
+} ndbcChunk;
+
+/* ndbc internal type ndbcArena
+ * An append-only output buffer made of a list of chunks.
+ * Unlike ndbcBuffer, data that has been written is never moved, so growing the arena never copies earlier output.
+ * head - The first chunk.
+ * tail - The chunk currently being written.
+ * len - The total number of bytes in use across all chunks.
+ */
+typedef struct {
+  ndbcChunk* head;
+  ndbcChunk* tail;
+  size_t len;
+} ndbcArena;
+
+/* ndbc internal function ndbcArenaReserve
+ * Returns a pointer to at least <more> bytes of free space at the end of the arena, adding a chunk if necessary.
+ * New chunks grow with the arena from 4KB up to 1MB, so small results stay small and large results use few chunks.
+ * Returns NULL if memory could not be allocated.
+ */
+char* ndbcArenaReserve(ndbcArena* arena, size_t more) {
+  ndbcChunk* chunk;
+  size_t size = arena->len;
+
+  if (arena->tail != NULL && arena->tail->size - arena->tail->len >= more) {
+    return arena->tail->data + arena->tail->len;
+  }
+  if (size < 4096) {
+    size = 4096;
+  } else if (size > 1048576) {
+    size = 1048576;
+  }
+  if (size < more) {
+    size = more;
+  }
+  if (size > ((size_t) -1) - sizeof(ndbcChunk)) {
+    return NULL;
+  }
+  chunk = (ndbcChunk*) malloc(sizeof(ndbcChunk) + size);
+  if (chunk == NULL) {
+    return NULL;
+  }
+  chunk->next = NULL;
+  chunk->len = 0;
+  chunk->size = size;
+  if (arena->tail != NULL) {
+    arena->tail->next = chunk;
+  } else {
+    arena->head = chunk;
+  }
+  arena->tail = chunk;
+  return chunk->data;
+}
+
+/* ndbc internal function ndbcArenaCommit
+ * Marks <len> bytes written to the space returned by ndbcArenaReserve as in use.
+ */
+void ndbcArenaCommit(ndbcArena* arena, size_t len) {
+  arena->tail->len += len;
+  arena->len += len;
+}
+
+/* ndbc internal function ndbcArenaToString
+ * Copies the arena contents to retVal as a single string.
+ * Output spanning several chunks is gathered into one exactly sized buffer first.
+ * Returns false, with retVal set to an error string, if memory could not be allocated or the contents are longer
+ * than ndbcMaxString.
+ */
+bool ndbcArenaToString(ndbcArena* arena, Local<Value>& retVal) {
+  ndbcChunk* chunk;
+  char* data;
+  size_t k = 0;
+
+  if (arena->head == NULL) {
+    retVal = String::New("");
+    return true;
+  }
+  if (arena->len > ndbcMaxString) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  if (arena->head->next == NULL) {
+    retVal = String::New(arena->head->data, (int) arena->len);
+    return true;
+  }
+  data = (char*) malloc(arena->len);
+  if (data == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  for (chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+    memcpy(data + k, chunk->data, chunk->len);
+    k += chunk->len;
+  }
+  retVal = String::New(data, (int) arena->len);
+  free(data);
+  return true;
+}
+
+/* ndbc internal function ndbcFreeArena
+ * Frees every chunk of an arena and leaves it empty.
+ */
+void ndbcFreeArena(ndbcArena* arena) {
+  ndbcChunk* chunk;
+
+  while (arena->head != NULL) {
+    chunk = arena->head;
+    arena->head = chunk->next;
+    free(chunk);
+  }
+  arena->tail = NULL;
+  arena->len = 0;
+}
+
+/* ndbc internal function ndbcArenaAlloc
+ * Returns <size> bytes of space at the end of the arena, aligned to 8 bytes, and marks them as in use.
+ * Allocations never move, so an arena can hold linked data that is released all at once.
+ * Returns NULL if memory could not be allocated.
+ */
+char* ndbcArenaAlloc(ndbcArena* arena, size_t size) {
+  char* data = (size < ((size_t) -1) - 7) ? ndbcArenaReserve(arena, size + 7) : NULL;
+  size_t pad;
+
+  if (data == NULL) {
+    return NULL;
+  }
+  pad = (8 - ((size_t) data & 7)) & 7;
+  ndbcArenaCommit(arena, pad + size);
+  return data + pad;
+}
+
+/* ndbc internal function ndbcArenaReset
+ * Empties an arena for reuse while keeping its memory.
+ * An arena that grew past one chunk is merged into a single chunk of the same total size, so the next use of the
+ * same size fits without allocating.
+ */
+void ndbcArenaReset(ndbcArena* arena) {
+  ndbcChunk* chunk;
+  size_t size = 0;
+
+  if (arena->head != NULL && arena->head->next != NULL) {
+    for (chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+      size += chunk->size;
+    }
+    ndbcFreeArena(arena);
+    // If the merged chunk cannot be allocated, the arena is simply left empty.
+    ndbcArenaReserve(arena, size);
+  }
+  if (arena->head != NULL) {
+    arena->head->len = 0;
+  }
+  arena->tail = arena->head;
+  arena->len = 0;
+}
+
+/* ndbc internal type ndbcColumnMeta
+ * Metadata for one column of a result set, collected by ndbcDescribeResult.
+ * name - The column name, null terminated.
+ * nameLen - The length of the column name.
+ * typeName - The data source's name for the column's data type, null terminated.
+ * type - The SQL data type of the column.
+ * size - The column size, as reported by SQLDescribeCol.
+ * digits - The decimal digits of the column, as reported by SQLDescribeCol.
+ * nullable - SQL_NO_NULLS, SQL_NULLABLE or SQL_NULLABLE_UNKNOWN.
+ * precision - The precision of numeric columns.
+ * scale - The scale of numeric columns.
+ * displaySize - The maximum number of characters required to display the column's data.
+ * isUnsigned - Whether the column's data type is unsigned (or not numeric).
+ */
+typedef struct {
+  char* name;
+  SQLSMALLINT nameLen;
+  char* typeName;
+  SQLSMALLINT type;
+  SQLULEN size;
+  SQLSMALLINT digits;
+  SQLSMALLINT nullable;
+  SQLLEN precision;
+  SQLLEN scale;
+  SQLLEN displaySize;
+  bool isUnsigned;
+} ndbcColumnMeta;
+
+/* ndbc internal type ndbcResultMeta
+ * Metadata for every column of a result set.
+ * columns - The number of columns.
+ * column - The metadata of each column.
+ */
+typedef struct {
+  SQLSMALLINT columns;
+  ndbcColumnMeta* column;
+} ndbcResultMeta;
+
+/* ndbc internal type ndbcStatementState
+ * Per-statement data kept by the extension functions between calls.
+ * next - The next state in the same registry bucket.
+ * statement - The statement handle this state belongs to.
+ * rowTime - Moving average of the time taken to fetch and serialize one row, in nanoseconds.  0 until measured.
+ * rowBytes - Moving average of the serialized length of one row.  0 until measured.
+ * heldRow - A fetched row that did not fit the previous call's output, returned before fetching again.  NULL if none.
+ *           Stored as each column's indicator value followed by its data.
+ * heldColumns - The number of columns in heldRow.
+ * meta - The metadata of the current result set, collected on first use.  NULL until then.
+ * scratch - Memory reused by each result set of the statement, holding meta and its strings.
+ * params - Memory holding the statement's bound parameter values and indicators, kept until parameters are next bound.
+ * paramStatus - The status of each row of the bound parameter set, in params.  NULL until parameters are bound.
+ * paramsProcessed - The number of rows of the bound parameter set processed by the last execution, in params.
+ * rowset - Memory holding the values and indicators of columns bound by BindRowset, kept until columns are next bound.
+ * rowStatus - The status of each row of the bound rowset, in rowset.  NULL until a rowset is bound.
+ * rowsetSize - The number of rows in the bound rowset.
+ * rowBlock - Memory reused by each fetch call on the statement, holding the bound row buffers.  NULL until used.
+ * rowBlockSize - The size of rowBlock.
+ */
+typedef struct ndbcStatementState {
+  struct ndbcStatementState* next;
+  SQLHANDLE statement;
+  double rowTime;
+  double rowBytes;
+  char* heldRow;
+  SQLSMALLINT heldColumns;
+  ndbcResultMeta* meta;
+  ndbcArena scratch;
+  ndbcArena params;
+  SQLUSMALLINT* paramStatus;
+  SQLULEN* paramsProcessed;
+  ndbcArena rowset;
+  SQLUSMALLINT* rowStatus;
+  SQLUINTEGER rowsetSize;
+  char* rowBlock;
+  size_t rowBlockSize;
+} ndbcStatementState;
+
+/* ndbc internal variable ndbcStatementStates
+ * Registry of statement states, hashed on the statement handle.
+ */
+ndbcStatementState* ndbcStatementStates[64];
+
+/* ndbc internal function ndbcGetStatementState
+ * Returns the state kept for a statement handle.
+ * If there is none yet, creates an empty one when create is true and returns NULL otherwise.
+ * Also returns NULL if memory could not be allocated.
+ */
+ndbcStatementState* ndbcGetStatementState(SQLHANDLE statement, bool create) {
+  ndbcStatementState** bucket = &ndbcStatementStates[((size_t) statement >> 4) & 63];
+  ndbcStatementState* state;
+
+  for (state = *bucket; state != NULL; state = state->next) {
+    if (state->statement == statement) {
+      return state;
+    }
+  }
+  if (create) {
+    state = (ndbcStatementState*) calloc(1, sizeof(ndbcStatementState));
+    if (state != NULL) {
+      state->statement = statement;
+      state->next = *bucket;
+      *bucket = state;
+    }
+  }
+  return state;
+}
+
+/* ndbc internal function ndbcFreeStatementState
+ * Discards the state kept for a statement handle, if any.
+ */
+void ndbcFreeStatementState(SQLHANDLE statement) {
+  ndbcStatementState** link = &ndbcStatementStates[((size_t) statement >> 4) & 63];
+  ndbcStatementState* state;
+
+  for (state = *link; state != NULL; link = &state->next, state = state->next) {
+    if (state->statement == statement) {
+      *link = state->next;
+      free(state->heldRow);
+      ndbcFreeArena(&state->scratch);
+      ndbcFreeArena(&state->params);
+      ndbcFreeArena(&state->rowset);
+      free(state->rowBlock);
+      free(state);
+      return;
+    }
+  }
+}
+
+/* ndbc internal function ndbcResetStatementState
+ * Clears the parts of a statement's state that belong to its current result set.
+ * Called whenever the statement moves to a new result set, so no held row, row cost estimate or metadata
+ * carries over.  The memory the metadata used is kept for the next result set.
+ */
+void ndbcResetStatementState(SQLHANDLE statement) {
+  ndbcStatementState* state = ndbcGetStatementState(statement, false);
+
+  if (state != NULL) {
+    free(state->heldRow);
+    state->heldRow = NULL;
+    state->heldColumns = 0;
+    state->rowTime = 0;
+    state->rowBytes = 0;
+    ndbcArenaReset(&state->scratch);
+    state->meta = NULL;
+  }
+}
+
+/* ndbc internal function ndbcHash
+ * Returns the FNV-1a hash of len bytes of data.
+ */
+SQLUINTEGER ndbcHash(const char* data, size_t len) {
+  SQLUINTEGER hash = 2166136261U;
+  size_t i;
+
+  for (i = 0; i < len; i++) {
+    hash ^= (unsigned char) data[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+/* ndbc internal type ndbcCachedStatement
+ * A prepared statement kept in a connection's statement cache.
+ * prev - The next more recently used entry, or NULL for the most recently used.
+ * next - The next less recently used entry, or NULL for the least recently used.
+ * chain - The next entry in the same hash bucket.
+ * statement - The statement handle the query is prepared on.
+ * hash - The hash of the query text.
+ * queryLen - The length of the query text.
+ * query - The query text, allocated together with the entry.
+ */
+typedef struct ndbcCachedStatement {
+  struct ndbcCachedStatement* prev;
+  struct ndbcCachedStatement* next;
+  struct ndbcCachedStatement* chain;
+  SQLHANDLE statement;
+  SQLUINTEGER hash;
+  SQLINTEGER queryLen;
+  char query[1];
+} ndbcCachedStatement;
+
+/* ndbc internal type ndbcConnectionState
+ * Per-connection data kept by the extension functions between calls.
+ * next - The next state in the same registry bucket.
+ * connection - The connection handle this state belongs to.
+ * capacity - The number of prepared statements the statement cache keeps.
+ * count - The number of prepared statements in the statement cache.
+ * head - The most recently used cache entry.  NULL if the cache is empty.
+ * tail - The least recently used cache entry.  NULL if the cache is empty.
+ * buckets - Hash table of the cache entries on their query text.
+ * hits - The number of executions that reused a cached statement.
+ * misses - The number of executions that prepared a new statement.
+ * evictions - The number of cached statements freed to make room for others.
+ * groupInterval - The longest time in milliseconds a write waits for its group to be committed.  0 if group commit is off.
+ * groupTimer - Commits the open group once its interval is up.  Only running while writes are waiting.
+ *              NULL if group commit is off.
+ * groupWaiters - The callbacks of the writes waiting for the open group to be committed.  Empty if there are none.
+ * groupCommits - The number of groups committed.
+ * groupWrites - The number of writes committed in groups.
+ */
+typedef struct ndbcConnectionState {
+  struct ndbcConnectionState* next;
+  SQLHANDLE connection;
+  SQLUINTEGER capacity;
+  SQLUINTEGER count;
+  ndbcCachedStatement* head;
+  ndbcCachedStatement* tail;
+  ndbcCachedStatement* buckets[256];
+  double hits;
+  double misses;
+  double evictions;
+  SQLUINTEGER groupInterval;
+  uv_timer_t* groupTimer;
+  Persistent<Array> groupWaiters;
+  double groupCommits;
+  double groupWrites;
+} ndbcConnectionState;
+
+/* ndbc internal variable ndbcConnectionStates
+ * Registry of connection states, hashed on the connection handle.
+ */
+ndbcConnectionState* ndbcConnectionStates[16];
+
+/* ndbc internal function ndbcGetConnectionState
+ * Returns the state kept for a connection handle.
+ * If there is none yet, creates an empty one with a statement cache capacity of 64 when create is true, and
+ * returns NULL otherwise.
+ * Also returns NULL if memory could not be allocated.
+ */
+ndbcConnectionState* ndbcGetConnectionState(SQLHANDLE connection, bool create) {
+  ndbcConnectionState** bucket = &ndbcConnectionStates[((size_t) connection >> 4) & 15];
+  ndbcConnectionState* state;
+
+  for (state = *bucket; state != NULL; state = state->next) {
+    if (state->connection == connection) {
+      return state;
+    }
+  }
+  if (create) {
+    state = (ndbcConnectionState*) calloc(1, sizeof(ndbcConnectionState));
+    if (state != NULL) {
+      state->connection = connection;
+      state->capacity = 64;
+      state->next = *bucket;
+      *bucket = state;
+    }
+  }
+  return state;
+}
+
+/* ndbc internal function ndbcDropCachedStatement
+ * Removes an entry from a connection's statement cache and frees it, along with the statement's state.
+ * The statement handle itself is freed only if freeHandle is true, since it no longer exists once the
+ * connection has been disconnected.
+ */
+void ndbcDropCachedStatement(ndbcConnectionState* state, ndbcCachedStatement* entry, bool freeHandle) {
+  ndbcCachedStatement** link;
+
+  for (link = &state->buckets[entry->hash & 255]; *link != NULL; link = &(*link)->chain) {
+    if (*link == entry) {
+      *link = entry->chain;
+      break;
+    }
+  }
+  if (entry->prev != NULL) {
+    entry->prev->next = entry->next;
+  } else {
+    state->head = entry->next;
+  }
+  if (entry->next != NULL) {
+    entry->next->prev = entry->prev;
+  } else {
+    state->tail = entry->prev;
+  }
+  state->count--;
+  if (freeHandle) {
+    SQLFreeHandle(SQL_HANDLE_STMT, entry->statement);
+  }
+  ndbcFreeStatementState(entry->statement);
+  free(entry);
+}
+
+/* ndbc internal function ndbcClearStatementCache
+ * Frees every prepared statement in a connection's statement cache.
+ * Called before the connection is disconnected, which would otherwise free the statements behind the cache's back.
+ */
+void ndbcClearStatementCache(SQLHANDLE connection) {
+  ndbcConnectionState* state = ndbcGetConnectionState(connection, false);
+
+  while (state != NULL && state->head != NULL) {
+    ndbcDropCachedStatement(state, state->head, true);
+  }
+}
+
+/* ndbc internal function ndbcFreeTimer
+ * Frees a timer once libuv has closed it.
+ */
+void ndbcFreeTimer(uv_handle_t* handle) {
+  free(handle);
+}
+
+/* ndbc internal function ndbcSettleGroup
+ * Calls back every write waiting on a connection's open group with result, null if the group was committed or
+ * a string describing how it ended otherwise, and stops the group commit timer.
+ * The waiters are taken off the connection first, so writes made by the callbacks join the next group.
+ */
+void ndbcSettleGroup(ndbcConnectionState* state, Handle<Value> result) {
+  HandleScope scope;
+  Local<Array> waiters;
+  Handle<Value> argv[1];
+  SQLUINTEGER i;
+
+  if (state->groupTimer != NULL) {
+    uv_timer_stop(state->groupTimer);
+  }
+  if (state->groupWaiters.IsEmpty()) {
+    return;
+  }
+  waiters = Local<Array>::New(state->groupWaiters);
+  state->groupWaiters.Dispose();
+  state->groupWaiters.Clear();
+  if (result->IsNull()) {
+    state->groupCommits++;
+    state->groupWrites += waiters->Length();
+  }
+
+  argv[0] = result;
+  for (i = 0; i < waiters->Length(); i++) {
+    // Each callback gets its own TryCatch, so one that throws does not keep the rest from being called.
+    TryCatch tryCatch;
+    Local<Function>::Cast(waiters->Get(i))->Call(Context::GetCurrent()->Global(), 1, argv);
+    if (tryCatch.HasCaught()) {
+      node::FatalException(tryCatch);
+    }
+  }
+}
+
+/* ndbc internal function ndbcCommitGroup
+ * Commits a connection's open group and calls back its waiting writes.
+ * A group that fails to commit is rolled back, so its writes are not folded into the next group, and its writes
+ * are called back with 'SQL_ERROR'.
+ * If end is true, also turns group commit off, closing the timer and turning SQL_ATTR_AUTOCOMMIT back on.
+ * The writes are called back last, since a callback may turn group commit on again or free the connection, so the
+ * state must not be used after this returns without being looked up again.
+ * Returns the result of SQLEndTran.
+ */
+SQLRETURN ndbcCommitGroup(ndbcConnectionState* state, bool end) {
+  SQLRETURN rc = SQLEndTran(SQL_HANDLE_DBC, state->connection, SQL_COMMIT);
+
+  if (rc == SQL_ERROR || rc == SQL_INVALID_HANDLE) {
+    SQLEndTran(SQL_HANDLE_DBC, state->connection, SQL_ROLLBACK);
+  }
+  if (end) {
+    uv_timer_stop(state->groupTimer);
+    uv_close((uv_handle_t*) state->groupTimer, ndbcFreeTimer);
+    state->groupTimer = NULL;
+    state->groupInterval = 0;
+    SQLSetConnectAttr(state->connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, 0);
+  }
+  if (rc == SQL_ERROR || rc == SQL_INVALID_HANDLE) {
+    ndbcSettleGroup(state, ndbcSQL_ERROR);
+  } else {
+    ndbcSettleGroup(state, Null());
+  }
+  return rc;
+}
+
+/* ndbc internal function ndbcGroupCommitTimer
+ * Commits a connection's open group once its interval is up.
+ */
+void ndbcGroupCommitTimer(uv_timer_t* timer, int) {
+  HandleScope scope;
+
+  ndbcCommitGroup((ndbcConnectionState*) timer->data, false);
+}
+
+/* ndbc internal function ndbcFreeConnectionState
+ * Discards the state kept for a connection handle, if any.
+ * Called once the connection handle has been freed, so any statements left in its cache are already gone.
+ * Writes still waiting on a group commit are called back with 'SQL_ROLLBACK', since they can no longer be committed.
+ */
+void ndbcFreeConnectionState(SQLHANDLE connection) {
+  ndbcConnectionState** link = &ndbcConnectionStates[((size_t) connection >> 4) & 15];
+  ndbcConnectionState* state;
+
+  for (; *link != NULL; link = &(*link)->next) {
+    state = *link;
+    if (state->connection == connection) {
+      *link = state->next;
+      while (state->head != NULL) {
+        ndbcDropCachedStatement(state, state->head, false);
+      }
+      // The state is already out of the registry, so callbacks that use the connection again do not find it.
+      if (state->groupTimer != NULL) {
+        uv_timer_stop(state->groupTimer);
+        uv_close((uv_handle_t*) state->groupTimer, ndbcFreeTimer);
+        state->groupTimer = NULL;
+      }
+      ndbcSettleGroup(state, ndbcSQL_ROLLBACK);
+      free(state);
+      return;
+    }
+  }
+}
+
 /* Mapping for SQLAllocHandle.
  * SQLAllocHandle(type, handle)
  * type - The handle type to allocate.
@@ -891,6 +1599,12 @@ try {
       retVal = ndbcSQL_INVALID_HANDLE;
       break;
     default:
+      // A new handle may reuse the address of a freed one, so never inherit its state.
+      if (handleType == SQL_HANDLE_STMT) {
+        ndbcFreeStatementState(newHandle);
+      } else if (handleType == SQL_HANDLE_DBC) {
+        ndbcFreeConnectionState(newHandle);
+      }
       retVal = External::Wrap(newHandle);
     }
   }
@@ -912,6 +1626,7 @@ catch (...) {
  * handle - The handle to be freed.
  *
  * Frees the specified handle.
+ * Freeing a statement or connection handle also discards any state the extension functions kept for it.
  * Returns the string 'SQL_SUCCESS' if it succeeds.
  * Any other return value indicates failure.
  */
@@ -945,6 +1660,11 @@ try {
       retVal = ndbcSQL_INVALID_HANDLE;
       break;
     default:
+      if (handleType == SQL_HANDLE_STMT) {
+        ndbcFreeStatementState((SQLHANDLE) External::Unwrap(args[1]));
+      } else if (handleType == SQL_HANDLE_DBC) {
+        ndbcFreeConnectionState((SQLHANDLE) External::Unwrap(args[1]));
+      }
       retVal = ndbcSQL_SUCCESS;
     }
   }
@@ -1105,18 +1825,24 @@ Handle<Value> ndbcSQLGetEnvAttr(const Arguments& args) {
 try {
   SQLINTEGER attrType;
   SQLPOINTER attrVal;
+  SQLULEN attrBuf[256 / sizeof(SQLULEN)];
   SQLINTEGER valLen;
   SQLINTEGER strLenPtr;
   bool ok = true;
 
   /* Allocate return buffer.
+   * Lengths that fit use a buffer on the stack, so the call does not allocate.
    */
   if (args.Length() == 3) {
     valLen = (SQLINTEGER) args[2]->Uint32Value();
   } else {
     valLen = 255;
   }
-  attrVal = (SQLPOINTER) malloc(valLen + 1);
+  if ((SQLUINTEGER) valLen < sizeof(attrBuf)) {
+    attrVal = (SQLPOINTER) attrBuf;
+  } else {
+    attrVal = (SQLPOINTER) malloc(valLen + 1);
+  }
 
   /* Translate string inputs into constant values.
    */
@@ -1204,7 +1930,9 @@ try {
     }
   }
 
-  free(attrVal);
+  if (attrVal != (SQLPOINTER) attrBuf) {
+    free(attrVal);
+  }
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -1262,6 +1990,7 @@ catch (...) {
  * connection - A connection handle created with SQLAllocHandle.
  *
  * Attempts to disconnect from the specified DSN.
+ * Any prepared statements cached for the connection by ndbcCachedExecute are freed first.
  * Returns the string 'SQL_SUCCESS' if it succeeds.
  * Returns the string value 'SQL_STILL_EXECUTING' if it is connecting asynchronously and the
  * connection is still being attempted.
@@ -1272,6 +2001,7 @@ Handle<Value> ndbcSQLDisconnect(const Arguments& args) {
   Local<Value> retVal;
 try {
 
+  ndbcClearStatementCache((SQLHANDLE) External::Unwrap(args[0]));
   switch (SQLDisconnect((SQLHDBC) External::Unwrap(args[0]))) {
   case SQL_ERROR:
     retVal = ndbcSQL_ERROR;
@@ -1334,7 +2064,7 @@ catch (...) {
  *     SQL_TRUE: Auto-IPD is supported.
  *     SQL_FALSE: Auto-IPD is not supported.
  *   SQL_ATTR_AUTOCOMMIT
- *     SQL_AUTOCOMMIT_OFF: Manually commit by calling SQLEndTrans.
+ *     SQL_AUTOCOMMIT_OFF: Manually commit by calling SQLEndTran.
  *     SQL_AUTOCOMMIT_ON: Automatically commit all statements immediately.
  *   SQL_ATTR_CONNECTION_DEAD (Read-only)
  *     SQL_CD_TRUE: Connection has been lost.
@@ -1582,7 +2312,7 @@ catch (...) {
  *     SQL_TRUE: Auto-IPD is supported.
  *     SQL_FALSE: Auto-IPD is not supported.
  *   SQL_ATTR_AUTOCOMMIT
- *     SQL_AUTOCOMMIT_OFF: Manually commit by calling SQLEndTrans.
+ *     SQL_AUTOCOMMIT_OFF: Manually commit by calling SQLEndTran.
  *     SQL_AUTOCOMMIT_ON: Automatically commit all statements immediately.
  *   SQL_ATTR_CONNECTION_DEAD (Read-only)
  *     SQL_CD_TRUE: Connection has been lost.
@@ -1621,18 +2351,24 @@ Handle<Value> ndbcSQLGetConnectAttr(const Arguments& args) {
 try {
   SQLINTEGER attrType;
   SQLPOINTER attrVal;
+  SQLULEN attrBuf[256 / sizeof(SQLULEN)];
   SQLINTEGER valLen;
   SQLINTEGER strLenPtr;
   bool ok = true;
 
   /* Allocate return buffer.
+   * Lengths that fit use a buffer on the stack, so the call does not allocate.
    */
   if (args.Length() == 3) {
     valLen = (SQLINTEGER) args[2]->Uint32Value();
   } else {
     valLen = 255;
   }
-  attrVal = (SQLPOINTER) malloc(valLen + 1);
+  if ((SQLUINTEGER) valLen < sizeof(attrBuf)) {
+    attrVal = (SQLPOINTER) attrBuf;
+  } else {
+    attrVal = (SQLPOINTER) malloc(valLen + 1);
+  }
 
   /* Translate string inputs into constant values.
    */
@@ -1842,7 +2578,9 @@ try {
     }
   }
 
-  free(attrVal);
+  if (attrVal != (SQLPOINTER) attrBuf) {
+    free(attrVal);
+  }
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -2940,13 +3678,16 @@ Handle<Value> ndbcSQLGetInfo(const Arguments& args) {
 try {
   SQLUSMALLINT attrType;
   SQLPOINTER attrVal;
+  SQLULEN attrBuf[256 / sizeof(SQLULEN)];
   SQLSMALLINT valLen;
   SQLSMALLINT strLenPtr;
   char* listVal;
+  char listBuf[1024];
   bool ok1 = true;
   bool ok2 = true;
 
   /* Allocate return buffer.
+   * Lengths that fit use a buffer on the stack, so the call does not allocate.
    */
   if (args.Length() == 4) {
     valLen = (SQLSMALLINT) args[3]->Uint32Value();
@@ -2957,7 +3698,11 @@ try {
   } else {
     valLen = 255;
   }
-  attrVal = (SQLPOINTER) malloc(valLen + 1);
+  if ((SQLUINTEGER) valLen < sizeof(attrBuf)) {
+    attrVal = (SQLPOINTER) attrBuf;
+  } else {
+    attrVal = (SQLPOINTER) malloc(valLen + 1);
+  }
   /* Translate string inputs into constant values.
    */
   if (args[1]->ToString() == ndbcSQL_ACCESSIBLE_PROCEDURES) {
@@ -3397,7 +4142,7 @@ try {
         retVal = Integer::NewFromUnsigned(*(SQLUINTEGER*)attrVal);
         break;
       case SQL_AGGREGATE_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_AF_ALL) == SQL_AF_ALL) {
           strcat(listVal, "SQL_AF_ALL,");
@@ -3424,10 +4169,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_ALTER_DOMAIN:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_AD_ADD_DOMAIN_CONSTRAINT) == SQL_AD_ADD_DOMAIN_CONSTRAINT) {
           strcat(listVal, "SQL_AD_ADD_DOMAIN_CONSTRAINT,");
@@ -3460,10 +4204,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_ALTER_TABLE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_AT_ADD_COLUMN_COLLATION) == SQL_AT_ADD_COLUMN_COLLATION) {
           strcat(listVal, "SQL_AT_ADD_COLUMN_COLLATION,");
@@ -3517,7 +4260,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_ASYNC_MODE:
         switch (*(SQLUINTEGER*)attrVal) {
@@ -3535,7 +4277,7 @@ try {
         }
         break;
       case SQL_BATCH_ROW_COUNT:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_BRC_ROLLED_UP) == SQL_BRC_ROLLED_UP) {
           strcat(listVal, "SQL_BRC_ROLLED_UP,");
@@ -3550,10 +4292,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_BATCH_SUPPORT:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_BS_SELECT_EXPLICIT) == SQL_BS_SELECT_EXPLICIT) {
           strcat(listVal, "SQL_BS_SELECT_EXPLICIT,");
@@ -3571,10 +4312,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_BOOKMARK_PERSISTENCE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_BP_CLOSE) == SQL_BP_CLOSE) {
           strcat(listVal, "SQL_BP_CLOSE,");
@@ -3598,7 +4338,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CATALOG_LOCATION:
         switch (*(SQLUSMALLINT*)attrVal) {
@@ -3616,7 +4355,7 @@ try {
         }
         break;
       case SQL_CATALOG_USAGE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CU_CATALOGS_NOT_SUPPORTED");
@@ -3641,7 +4380,6 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CONCAT_NULL_BEHAVIOR:
         switch (*(SQLUSMALLINT*)attrVal) {
@@ -3677,7 +4415,7 @@ try {
       case SQL_CONVERT_TINYINT:
       case SQL_CONVERT_VARBINARY:
       case SQL_CONVERT_VARCHAR:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_CVT_BIGINT) == SQL_CVT_BIGINT) {
           strcat(listVal, "SQL_CVT_BIGINT,");
@@ -3749,10 +4487,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CONVERT_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_CVT_CAST) == SQL_FN_CVT_CAST) {
           strcat(listVal, "SQL_FN_CVT_CAST,");
@@ -3764,7 +4501,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CORRELATION_NAME:
         switch (*(SQLUSMALLINT*)attrVal) {
@@ -3782,7 +4518,7 @@ try {
         }
         break;
       case SQL_CREATE_ASSERTION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CA_ASSERTIONS_NOT_SUPPORTED");
@@ -3807,10 +4543,9 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_CHARACTER_SET:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CCS_CHARACTER_SETS_NOT_SUPPORTED");
@@ -3829,10 +4564,9 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_COLLATION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CCOL_COLLATIONS_NOT_SUPPORTED");
@@ -3845,10 +4579,9 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_DOMAIN:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CDO_DOMAINS_NOT_SUPPORTED");
@@ -3876,10 +4609,9 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_SCHEMA:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_CS_CREATE_SCHEMA) == SQL_CS_CREATE_SCHEMA) {
           strcat(listVal, "SQL_CS_CREATE_SCHEMA,");
@@ -3894,10 +4626,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_TABLE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_CT_CREATE_TABLE) == SQL_CT_CREATE_TABLE) {
           strcat(listVal, "SQL_CT_CREATE_TABLE,");
@@ -3945,10 +4676,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_TRANSLATION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CTR_TRANSLATIONS_NOT_SUPPORTED");
@@ -3961,10 +4691,9 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CREATE_VIEW:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if (*(SQLUINTEGER*)attrVal == 0) {
           strcat(listVal, "SQL_CV_VIEWS_NOT_SUPPORTED");
@@ -3986,7 +4715,6 @@ try {
           }
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_CURSOR_COMMIT_BEHAVIOR:
       case SQL_CURSOR_ROLLBACK_BEHAVIOR:
@@ -4020,7 +4748,7 @@ try {
         }
         break;
       case SQL_DATETIME_LITERALS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DL_SQL92_DATE) == SQL_DL_SQL92_DATE) {
           strcat(listVal, "SQL_DL_SQL92_DATE,");
@@ -4074,10 +4802,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DDL_INDEX:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DI_CREATE_INDEX) == SQL_DI_CREATE_INDEX) {
           strcat(listVal, "SQL_DI_CREATE_INDEX,");
@@ -4089,7 +4816,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DEFAULT_TXN_ISOLATION:
         switch (*(SQLUINTEGER*)attrVal) {
@@ -4110,7 +4836,7 @@ try {
         }
         break;
       case SQL_DROP_ASSERTION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DA_DROP_ASSERTION) == SQL_DA_DROP_ASSERTION) {
           strcat(listVal, "SQL_DA_DROP_ASSERTION,");
@@ -4119,10 +4845,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_CHARACTER_SET:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DCS_DROP_CHARACTER_SET) == SQL_DCS_DROP_CHARACTER_SET) {
           strcat(listVal, "SQL_DCS_DROP_CHARACTER_SET,");
@@ -4131,10 +4856,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_COLLATION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DC_DROP_COLLATION) == SQL_DC_DROP_COLLATION) {
           strcat(listVal, "SQL_DC_DROP_COLLATION,");
@@ -4143,10 +4867,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_DOMAIN:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DD_DROP_DOMAIN) == SQL_DD_DROP_DOMAIN) {
           strcat(listVal, "SQL_DD_DROP_DOMAIN,");
@@ -4161,10 +4884,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_SCHEMA:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DS_DROP_SCHEMA) == SQL_DS_DROP_SCHEMA) {
           strcat(listVal, "SQL_DS_DROP_SCHEMA,");
@@ -4179,10 +4901,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_TABLE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DT_DROP_TABLE) == SQL_DT_DROP_TABLE) {
           strcat(listVal, "SQL_DT_DROP_TABLE,");
@@ -4197,10 +4918,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_TRANSLATION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DTR_DROP_TRANSLATION) == SQL_DTR_DROP_TRANSLATION) {
           strcat(listVal, "SQL_DTR_DROP_TRANSLATION,");
@@ -4209,10 +4929,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DROP_VIEW:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_DV_DROP_VIEW) == SQL_DV_DROP_VIEW) {
           strcat(listVal, "SQL_DV_DROP_VIEW,");
@@ -4227,13 +4946,12 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DYNAMIC_CURSOR_ATTRIBUTES1:
       case SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES1:
       case SQL_KEYSET_CURSOR_ATTRIBUTES1:
       case SQL_STATIC_CURSOR_ATTRIBUTES1:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_CA1_NEXT) == SQL_CA1_NEXT) {
           strcat(listVal, "SQL_CA1_NEXT,");
@@ -4293,13 +5011,12 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_DYNAMIC_CURSOR_ATTRIBUTES2:
       case SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES2:
       case SQL_KEYSET_CURSOR_ATTRIBUTES2:
       case SQL_STATIC_CURSOR_ATTRIBUTES2:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_CA2_READ_ONLY_CONCURRENCY) == SQL_CA2_READ_ONLY_CONCURRENCY) {
           strcat(listVal, "SQL_CA2_READ_ONLY_CONCURRENCY,");
@@ -4359,10 +5076,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_FILE_USAGE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FILE_NOT_SUPPORTED) == SQL_FILE_NOT_SUPPORTED) {
           strcat(listVal, "SQL_FILE_NOT_SUPPORTED,");
@@ -4377,10 +5093,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_GETDATA_EXTENSIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_GD_ANY_COLUMN) == SQL_GD_ANY_COLUMN) {
           strcat(listVal, "SQL_GD_ANY_COLUMN,");
@@ -4401,10 +5116,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_GROUP_BY:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUSMALLINT*)attrVal & SQL_GB_COLLATE) == SQL_GB_COLLATE) {
           strcat(listVal, "SQL_GB_COLLATE,");
@@ -4425,7 +5139,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_IDENTIFIER_CASE:
       case SQL_QUOTED_IDENTIFIER_CASE:
@@ -4447,7 +5160,7 @@ try {
         }
         break;
       case SQL_INDEX_KEYWORDS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_IK_NONE) == SQL_IK_NONE) {
           strcat(listVal, "SQL_IK_NONE,");
@@ -4465,10 +5178,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_INFO_SCHEMA_VIEWS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_ISV_ASSERTIONS) == SQL_ISV_ASSERTIONS) {
           strcat(listVal, "SQL_ISV_ASSERTIONS,");
@@ -4543,10 +5255,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_INSERT_STATEMENT:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_IS_INSERT_LITERALS) == SQL_IS_INSERT_LITERALS) {
           strcat(listVal, "SQL_IS_INSERT_LITERALS,");
@@ -4561,7 +5272,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_NON_NULLABLE_COLUMNS:
         switch (*(SQLUSMALLINT*)attrVal) {
@@ -4594,7 +5304,7 @@ try {
         }
         break;
       case SQL_NUMERIC_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_NUM_ABS) == SQL_FN_NUM_ABS) {
           strcat(listVal, "SQL_FN_NUM_ABS,");
@@ -4672,7 +5382,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_ODBC_INTERFACE_CONFORMANCE:
         switch (*(SQLUINTEGER*)attrVal) {
@@ -4690,7 +5399,7 @@ try {
         }
         break;
       case SQL_OJ_CAPABILITIES:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_OJ_LEFT) == SQL_OJ_LEFT) {
           strcat(listVal, "SQL_OJ_LEFT,");
@@ -4717,7 +5426,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_PARAM_ARRAY_ROW_COUNTS:
         switch (*(SQLUINTEGER*)attrVal) {
@@ -4747,7 +5455,7 @@ try {
         }
         break;
       case SQL_POS_OPERATIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_POS_POSITION) == SQL_POS_POSITION) {
           strcat(listVal, "SQL_POS_POSITION,");
@@ -4768,10 +5476,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SCHEMA_USAGE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SU_DML_STATEMENTS) == SQL_SU_DML_STATEMENTS) {
           strcat(listVal, "SQL_SU_DML_STATEMENTS,");
@@ -4792,10 +5499,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SCROLL_OPTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SO_FORWARD_ONLY) == SQL_SO_FORWARD_ONLY) {
           strcat(listVal, "SQL_SO_FORWARD_ONLY,");
@@ -4816,7 +5522,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL_CONFORMANCE:
         switch (*(SQLUINTEGER*)attrVal) {
@@ -4837,7 +5542,7 @@ try {
         }
         break;
       case SQL_SQL92_DATETIME_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SDF_CURRENT_DATE) == SQL_SDF_CURRENT_DATE) {
           strcat(listVal, "SQL_SDF_CURRENT_DATE,");
@@ -4852,10 +5557,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_FOREIGN_KEY_DELETE_RULE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SFKD_CASCADE) == SQL_SFKD_CASCADE) {
           strcat(listVal, "SQL_SFKD_CASCADE,");
@@ -4873,10 +5577,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_FOREIGN_KEY_UPDATE_RULE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SFKU_CASCADE) == SQL_SFKD_CASCADE) {
           strcat(listVal, "SQL_SFKD_CASCADE,");
@@ -4894,10 +5597,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_GRANT:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SG_DELETE_TABLE) == SQL_SG_DELETE_TABLE) {
           strcat(listVal, "SQL_SG_DELETE_TABLE,");
@@ -4942,10 +5644,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_NUMERIC_VALUE_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SNVF_BIT_LENGTH) == SQL_SNVF_BIT_LENGTH) {
           strcat(listVal, "SQL_SNVF_BIT_LENGTH,");
@@ -4969,10 +5670,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_PREDICATES:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SP_BETWEEN) == SQL_SP_BETWEEN) {
           strcat(listVal, "SQL_SP_BETWEEN,");
@@ -5020,10 +5720,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_RELATIONAL_JOIN_OPERATORS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SRJO_CORRESPONDING_CLAUSE) == SQL_SRJO_CORRESPONDING_CLAUSE) {
           strcat(listVal, "SQL_SRJO_CORRESPONDING_CLAUSE,");
@@ -5059,10 +5758,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_REVOKE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SR_CASCADE) == SQL_SR_CASCADE) {
           strcat(listVal, "SQL_SR_CASCADE,");
@@ -5113,10 +5811,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_ROW_VALUE_CONSTRUCTOR:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SRVC_VALUE_EXPRESSION) == SQL_SRVC_VALUE_EXPRESSION) {
           strcat(listVal, "SQL_SRVC_VALUE_EXPRESSION,");
@@ -5134,10 +5831,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_STRING_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SSF_CONVERT) == SQL_SSF_CONVERT) {
           strcat(listVal, "SQL_SSF_CONVERT,");
@@ -5167,10 +5863,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SQL92_VALUE_EXPRESSIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SVE_CASE) == SQL_SVE_CASE) {
           strcat(listVal, "SQL_SVE_CASE,");
@@ -5188,10 +5883,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_STANDARD_CLI_CONFORMANCE:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SCC_XOPEN_CLI_VERSION1) == SQL_SCC_XOPEN_CLI_VERSION1) {
           strcat(listVal, "SQL_SCC_XOPEN_CLI_VERSION1,");
@@ -5203,10 +5897,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_STRING_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_STR_ASCII) == SQL_FN_STR_ASCII) {
           strcat(listVal, "SQL_FN_STR_ASCII,");
@@ -5281,10 +5974,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SUBQUERIES:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_SQ_CORRELATED_SUBQUERIES) == SQL_SQ_CORRELATED_SUBQUERIES) {
           strcat(listVal, "SQL_SQ_CORRELATED_SUBQUERIES,");
@@ -5305,10 +5997,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_SYSTEM_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_SYS_DBNAME) == SQL_FN_SYS_DBNAME) {
           strcat(listVal, "SQL_FN_SYS_DBNAME,");
@@ -5323,10 +6014,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_TIMEDATE_ADD_INTERVALS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_TSI_FRAC_SECOND) == SQL_FN_TSI_FRAC_SECOND) {
           strcat(listVal, "SQL_FN_TSI_FRAC_SECOND,");
@@ -5359,10 +6049,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_TIMEDATE_DIFF_INTERVALS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_TSI_FRAC_SECOND) == SQL_FN_TSI_FRAC_SECOND) {
           strcat(listVal, "SQL_FN_TSI_FRAC_SECOND,");
@@ -5395,10 +6084,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_TIMEDATE_FUNCTIONS:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_FN_TD_CURRENT_DATE) == SQL_FN_TD_CURRENT_DATE) {
           strcat(listVal, "SQL_FN_TD_CURRENT_DATE,");
@@ -5467,7 +6155,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_TXN_CAPABLE:
         switch (*(SQLUSMALLINT*)attrVal) {
@@ -5491,7 +6178,7 @@ try {
         }
         break;
       case SQL_TXN_ISOLATION_OPTION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_TXN_READ_UNCOMMITTED) == SQL_TXN_READ_UNCOMMITTED) {
           strcat(listVal, "SQL_TXN_READ_UNCOMMITTED,");
@@ -5509,10 +6196,9 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       case SQL_UNION:
-        listVal = (char*) malloc(1024);
+        listVal = listBuf;
         listVal[0] = NULL;
         if ((*(SQLUINTEGER*)attrVal & SQL_U_UNION) == SQL_U_UNION) {
           strcat(listVal, "SQL_U_UNION,");
@@ -5524,7 +6210,6 @@ try {
           listVal[strlen(listVal) - 1] = NULL;
         }
         retVal = String::New(listVal);
-        free(listVal);
         break;
       default:
         retVal = ndbcINVALID_ARGUMENT;
@@ -5532,7 +6217,9 @@ try {
     }
   }
 
-  free(attrVal);
+  if (attrVal != (SQLPOINTER) attrBuf) {
+    free(attrVal);
+  }
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -5985,6 +6672,7 @@ Handle<Value> ndbcSQLGetStmtAttr(const Arguments& args) {
 try {
   SQLINTEGER attrType;
   SQLPOINTER attrVal;
+  SQLULEN attrBuf[256 / sizeof(SQLULEN)];
   SQLINTEGER valLen;
   SQLINTEGER strLenPtr;
   bool ok = true;
@@ -5995,7 +6683,11 @@ try {
   } else {
     valLen = 255;
   }
-  attrVal = (SQLPOINTER) malloc(valLen + 1);
+  if ((SQLUINTEGER) valLen < sizeof(attrBuf)) {
+    attrVal = (SQLPOINTER) attrBuf;
+  } else {
+    attrVal = (SQLPOINTER) malloc(valLen + 1);
+  }
 
   // Translate string inputs into constant values.
   if (args[1]->ToString() == ndbcSQL_ATTR_APP_PARAM_DESC) {
@@ -6268,7 +6960,9 @@ try {
     }
   }
 
-  free(attrVal);
+  if (attrVal != (SQLPOINTER) attrBuf) {
+    free(attrVal);
+  }
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -6298,6 +6992,7 @@ try {
   String::AsciiValue rawVal(args[1]->ToString());
   query = (SQLCHAR*) *rawVal;
   queryLen = rawVal.length();
+  ndbcResetStatementState((SQLHANDLE) External::Unwrap(args[0]));
   
   switch (SQLExecDirect((SQLHANDLE) External::Unwrap(args[0]), query, queryLen)) {
   case SQL_ERROR:
@@ -6329,32 +7024,44 @@ catch (...) {
   return scope.Close(retVal);
 }
 
-/* Mapping for SQLRowCount
- * SQLRowCount(statement)
+/* Mapping for SQLPrepare
+ * SQLPrepare(statement, query)
  * statement - An statement handle created with SQLAllocHandle.
+ * query - The query text to prepare on the server.  Parameters are marked with '?'.
  *
- * Retrieves the number of rows affected by the completed statement on supplied statement handle.
- * Returns the row count if it succeeds.
- * Any other return value indicates failure (SQL_ERROR, SQL_INVALID_HANDLE).
+ * Sends the query to the server to be parsed and planned, without running it.
+ * The prepared query stays on the statement handle and can be run any number of times with SQLExecute, skipping the
+ * parse and plan on each run, until another query is prepared or executed directly on the handle.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * Any other return value indicates failure.
  */
-Handle<Value> ndbcSQLRowCount(const Arguments& args) {
+Handle<Value> ndbcSQLPrepare(const Arguments& args) {
   HandleScope scope;
   Local<Value> retVal;
 try {
-  SQLLEN* rowCount = (SQLLEN*) malloc(sizeof(SQLLEN));
+  SQLCHAR* query;
+  SQLINTEGER queryLen;
+
+  String::AsciiValue rawVal(args[1]->ToString());
+  query = (SQLCHAR*) *rawVal;
+  queryLen = rawVal.length();
+  ndbcResetStatementState((SQLHANDLE) External::Unwrap(args[0]));
 
-  switch (SQLRowCount((SQLHANDLE) External::Unwrap(args[0]), rowCount)) {
+  switch (SQLPrepare((SQLHANDLE) External::Unwrap(args[0]), query, queryLen)) {
   case SQL_ERROR:
     retVal = ndbcSQL_ERROR;
     break;
   case SQL_INVALID_HANDLE:
     retVal = ndbcSQL_INVALID_HANDLE;
     break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
   default:
-    retVal = Integer::New(*rowCount);
+    retVal = ndbcSQL_SUCCESS;
   }
-  
-  free(rowCount);
+
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -6362,181 +7069,6117 @@ catch (...) {
   return scope.Close(retVal);
 }
 
-/* ndbc custom function ndbcJsonDescribe
- * ndbcJsonDescribe(statement)
- * statement - An statement handle that has an available result set.
- * 
- * Returns a string value describing how to bind result set data when returning rows via ndbcJsonData.
- * Designed to run synchronously.
- * Returns SQL_ERROR if there are any problems.
- * The returned string contains the following header information:
- *   columns: The character 'c' followed by a number representing the number of output columns.
- *   length: The character 'l' followed by the number of bytes required to represent a single row of data in Json format.
- *           This includes extra space for escape sequences, literal delimiters, and enclosing braces.
- * The returned string contains text for each column in the following format:
- *   serialize: A character representing how to serialize the column's data.
- *     q: Quoted, the data will be enclosed by double quotes and formatted into a string literal.
- *        Control characters 0x00-0x1f are replaced by spaces.
- *        Special character escape sequences \ to \\ and " to \" are applied.
- *     b: Quoted, the data will be enclosed by double quotes and encoded in base64 format.
- *     n: Not quoted, the data will not be enclosed by anything and will not be formatted.
- *   length: A number representing the maximum byte length of this field's output.
- *           This does not include extra space for escape sequences or null termination.
+/* Mapping for SQLExecute
+ * SQLExecute(statement)
+ * statement - An statement handle with a query prepared by SQLPrepare.
+ *
+ * Runs the query prepared on the statement handle.
+ * Any result set from an earlier run must have been read to the end or closed first (see SQLMoreResults).
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If the query ran but affected nothing, 'SQL_NO_DATA' is returned.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * If data needs to be supplied to the query while it is running, it may return 'SQL_NEED_DATA'.
+ * Any other return value indicates failure.
  */
-Handle<Value> ndbcJsonDescribe(const Arguments& args) {
+Handle<Value> ndbcSQLExecute(const Arguments& args) {
   HandleScope scope;
-  Local<String> retVal;
+  Local<Value> retVal;
 try {
-  Local<String> columnDesc = String::New("");
-  SQLSMALLINT* columns = (SQLSMALLINT*) malloc(sizeof(SQLSMALLINT*));
-  SQLUSMALLINT i;
-  SQLULEN recLen = 2;
-  bool ok = true;
-
-  SQLSMALLINT* dataType = (SQLSMALLINT*) malloc(sizeof(SQLSMALLINT*));
-  SQLULEN* dataLen = (SQLULEN*) malloc(sizeof(SQLULEN*));
+  ndbcResetStatementState((SQLHANDLE) External::Unwrap(args[0]));
 
-  // Call SQLNumResultCols to get the number of columns in the result set
-  switch (SQLNumResultCols((SQLHANDLE) External::Unwrap(args[0]), columns)) {
+  switch (SQLExecute((SQLHANDLE) External::Unwrap(args[0]))) {
   case SQL_ERROR:
     retVal = ndbcSQL_ERROR;
     break;
   case SQL_INVALID_HANDLE:
     retVal = ndbcSQL_INVALID_HANDLE;
     break;
+  case SQL_NEED_DATA:
+    retVal = ndbcSQL_NEED_DATA;
+    break;
   case SQL_STILL_EXECUTING:
     retVal = ndbcSQL_STILL_EXECUTING;
     break;
+  case SQL_NO_DATA:
+    retVal = ndbcSQL_NO_DATA;
+    break;
+  case SQL_PARAM_DATA_AVAILABLE:
+    retVal = ndbcSQL_PARAM_DATA_AVAILABLE;
+    break;
   default:
-    // Encode the column count to the output
-    retVal = String::New("c");
-    retVal = String::Concat(retVal, Integer::New(*columns)->ToString());
-    // Call SQLDescribeCol for each column in the result set
-    for (i = 1; i <= *columns && ok; i++) {
-      // Encode the column description into a placeholder V8 string and increment the total record length
-      switch (SQLDescribeCol((SQLHANDLE) External::Unwrap(args[0]), i, NULL, 0, NULL, dataType, dataLen, NULL, NULL)) {
-      case SQL_ERROR:
-        retVal = ndbcSQL_ERROR;
-        ok = false;
-        break;
-      case SQL_INVALID_HANDLE:
-        retVal = ndbcSQL_INVALID_HANDLE;
-        ok = false;
-        break;
-      case SQL_STILL_EXECUTING:
-        retVal = ndbcSQL_STILL_EXECUTING;
-        ok = false;
-        break;
-      default:
-        // Minimum output length is 5 for NULL data represented as 'null' plus a comma.
-        switch (*dataType) {
-        case SQL_DECIMAL:
-        case SQL_NUMERIC:
-          // Add in 2 for a decimal point and a sign.
-          *dataLen += 2;
-          // Add 1 for a comma, and make sure the resulting length is at least 5.
-          recLen += ((*dataLen > 4) ? *dataLen : 4) + 1;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
-          break;
-        case SQL_BIT:
-          *dataLen = 1;
-          // Minimum output length is 5.
-          recLen += 5;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
-          break;
-        case SQL_TINYINT:
-          *dataLen = 4;
-          // Add 1 for a comma.
-          recLen += 5;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
-          break;
-        case SQL_SMALLINT:
-          *dataLen = 6;
-          recLen += 7;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
-          break;
-        case SQL_INTEGER:
-          *dataLen = 11;
-          recLen += 12;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
-          break;
+    retVal = ndbcSQL_SUCCESS;
+  }
+
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLParamData
+ * SQLParamData(statement)
+ * statement - An statement handle whose query returned 'SQL_NEED_DATA' from SQLExecute or SQLExecDirect.
+ *
+ * Moves to the next data-at-execution parameter, or runs the query once every such parameter has been sent.
+ * Returns the number of the parameter whose data is needed next, as bound by BindDataAtExec.  Send its data with
+ * SQLPutData, then call SQLParamData again.
+ * Returns the string 'SQL_SUCCESS' once the query has run.
+ * If the query ran but affected nothing, 'SQL_NO_DATA' is returned.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLParamData(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLPOINTER token = NULL;
+
+  switch (SQLParamData((SQLHANDLE) External::Unwrap(args[0]), &token)) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  case SQL_NEED_DATA:
+    retVal = Integer::NewFromUnsigned((uint32_t) (SQLULEN) token);
+    break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
+  case SQL_NO_DATA:
+    retVal = ndbcSQL_NO_DATA;
+    break;
+  case SQL_PARAM_DATA_AVAILABLE:
+    retVal = ndbcSQL_PARAM_DATA_AVAILABLE;
+    break;
+  default:
+    retVal = ndbcSQL_SUCCESS;
+  }
+
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLPutData
+ * SQLPutData(statement, data)
+ * statement - An statement handle whose last call to SQLParamData returned a parameter number.
+ * data - A Buffer or string holding the next part of the parameter's value, or null to send a null value.
+ *        Strings are sent as UTF-8.
+ *
+ * Sends part of the value of a data-at-execution parameter.  Call it as many times as needed to send the whole
+ * value, then call SQLParamData.  See also PutStream, which sends the contents of a stream.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLPutData(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLRETURN status;
+
+  if (args[1]->IsNull()) {
+    status = SQLPutData((SQLHANDLE) External::Unwrap(args[0]), NULL, SQL_NULL_DATA);
+  } else if (node::Buffer::HasInstance(args[1])) {
+    status = SQLPutData((SQLHANDLE) External::Unwrap(args[0]), (SQLPOINTER) node::Buffer::Data(args[1]->ToObject()),
+                        (SQLLEN) node::Buffer::Length(args[1]->ToObject()));
+  } else {
+    String::Utf8Value rawVal(args[1]->ToString());
+    status = SQLPutData((SQLHANDLE) External::Unwrap(args[0]), (SQLPOINTER) *rawVal, (SQLLEN) rawVal.length());
+  }
+  switch (status) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
+  default:
+    retVal = ndbcSQL_SUCCESS;
+  }
+
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLSetPos
+ * SQLSetPos(statement, row, operation, [lock])
+ * statement - An statement handle with a fetched rowset.
+ * row - The row of the rowset to act on, starting from 1, or 0 for every row of the rowset.
+ * operation - One of the following strings:
+ *   SQL_POSITION: Positions the cursor on the row.
+ *   SQL_REFRESH: Refetches the row's data into the bound columns.
+ *   SQL_UPDATE: Updates the row from the data in the bound columns (see BindRowset).
+ *   SQL_DELETE: Deletes the row.
+ * lock - SQL_LOCK_NO_CHANGE, SQL_LOCK_EXCLUSIVE or SQL_LOCK_UNLOCK.  Defaults to SQL_LOCK_NO_CHANGE.
+ *
+ * Acts on one or all rows of the rowset of a block cursor.  The cursor must support the operation, as reported by
+ * SQLGetInfo for the cursor type (SQL_CA1_POS_*).  The status of each row can be read with RowStatus.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * If data needs to be supplied while the operation runs, it may return 'SQL_NEED_DATA'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLSetPos(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLUSMALLINT operation = SQL_POSITION;
+  SQLUSMALLINT lock = SQL_LOCK_NO_CHANGE;
+  bool ok = true;
+
+  if (args[2]->ToString() == ndbcSQL_POSITION) {
+    operation = SQL_POSITION;
+  } else if (args[2]->ToString() == ndbcSQL_REFRESH) {
+    operation = SQL_REFRESH;
+  } else if (args[2]->ToString() == ndbcSQL_UPDATE) {
+    operation = SQL_UPDATE;
+  } else if (args[2]->ToString() == ndbcSQL_DELETE) {
+    operation = SQL_DELETE;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args.Length() >= 4 && !args[3]->IsUndefined()) {
+    if (args[3]->ToString() == ndbcSQL_LOCK_NO_CHANGE) {
+      lock = SQL_LOCK_NO_CHANGE;
+    } else if (args[3]->ToString() == ndbcSQL_LOCK_EXCLUSIVE) {
+      lock = SQL_LOCK_EXCLUSIVE;
+    } else if (args[3]->ToString() == ndbcSQL_LOCK_UNLOCK) {
+      lock = SQL_LOCK_UNLOCK;
+    } else {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+  }
+
+  if (ok) {
+    switch (SQLSetPos((SQLHANDLE) External::Unwrap(args[0]), (SQLSETPOSIROW) args[1]->Uint32Value(), operation, lock)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      break;
+    default:
+      retVal = ndbcSQL_SUCCESS;
+    }
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLBulkOperations
+ * SQLBulkOperations(statement, operation)
+ * statement - An statement handle with an open cursor.
+ * operation - One of the following strings:
+ *   SQL_ADD: Inserts the rows in the bound columns (see BindRowset).
+ *   SQL_UPDATE_BY_BOOKMARK: Updates the rows identified by the bound bookmark column from the other bound columns.
+ *   SQL_DELETE_BY_BOOKMARK: Deletes the rows identified by the bound bookmark column.
+ *   SQL_FETCH_BY_BOOKMARK: Fetches the rows identified by the bound bookmark column.
+ *
+ * Acts on every row of the bound rowset in one call.  The cursor must support the operation, as reported by
+ * SQLGetInfo for the cursor type (SQL_CA1_BULK_*).  The status of each row can be read with RowStatus.
+ * See also BulkWrite, which falls back to parameter arrays for drivers without bulk operations.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * If data needs to be supplied while the operation runs, it may return 'SQL_NEED_DATA'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLBulkOperations(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLUSMALLINT operation = SQL_ADD;
+  bool ok = true;
+
+  if (args[1]->ToString() == ndbcSQL_ADD) {
+    operation = SQL_ADD;
+  } else if (args[1]->ToString() == ndbcSQL_UPDATE_BY_BOOKMARK) {
+    operation = SQL_UPDATE_BY_BOOKMARK;
+  } else if (args[1]->ToString() == ndbcSQL_DELETE_BY_BOOKMARK) {
+    operation = SQL_DELETE_BY_BOOKMARK;
+  } else if (args[1]->ToString() == ndbcSQL_FETCH_BY_BOOKMARK) {
+    operation = SQL_FETCH_BY_BOOKMARK;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+
+  if (ok) {
+    switch (SQLBulkOperations((SQLHANDLE) External::Unwrap(args[0]), operation)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      break;
+    default:
+      retVal = ndbcSQL_SUCCESS;
+    }
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLRowCount
+ * SQLRowCount(statement)
+ * statement - An statement handle created with SQLAllocHandle.
+ *
+ * Retrieves the number of rows affected by the completed statement on supplied statement handle.
+ * Returns the row count if it succeeds.
+ * Any other return value indicates failure (SQL_ERROR, SQL_INVALID_HANDLE).
+ */
+Handle<Value> ndbcSQLRowCount(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLLEN rowCount = 0;
+
+  switch (SQLRowCount((SQLHANDLE) External::Unwrap(args[0]), &rowCount)) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  default:
+    retVal = Number::New((double) rowCount);
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLMoreResults
+ * SQLMoreResults(statement)
+ * statement - An statement handle created with SQLAllocHandle.
+ *
+ * Moves the statement on to its next result set, discarding any unread rows of the current one.
+ * Batched statements and stored procedures can return several result sets from one round trip.
+ * Call JsonDescribe again after moving on, since each result set has its own columns.
+ * Returns the string 'SQL_SUCCESS' if another result set is available.
+ * Returns the string 'SQL_NO_DATA' if there are no more result sets.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLMoreResults(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  ndbcResetStatementState((SQLHANDLE) External::Unwrap(args[0]));
+
+  switch (SQLMoreResults((SQLHANDLE) External::Unwrap(args[0]))) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
+  case SQL_NO_DATA:
+    retVal = ndbcSQL_NO_DATA;
+    break;
+  case SQL_PARAM_DATA_AVAILABLE:
+    retVal = ndbcSQL_PARAM_DATA_AVAILABLE;
+    break;
+  default:
+    retVal = ndbcSQL_SUCCESS;
+  }
+  
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* Mapping for SQLEndTran
+ * SQLEndTran(type, handle, completion)
+ * type - The type of handle.
+ *   SQL_HANDLE_ENV: Ends the transactions of every connection of an environment handle.
+ *   SQL_HANDLE_DBC: Ends the transaction of a connection handle.
+ * handle - The environment or connection handle.
+ * completion - One of the following strings:
+ *   SQL_COMMIT: Commits the transaction.
+ *   SQL_ROLLBACK: Rolls the transaction back.
+ *
+ * Ends the open transaction of a connection with SQL_ATTR_AUTOCOMMIT set to SQL_AUTOCOMMIT_OFF.
+ * If the connection is in group commit mode (see GroupCommit), the writes waiting on the open group are called back
+ * before it returns: with null if it was committed, or 'SQL_ROLLBACK' if it was rolled back.
+ * Returns 'INVALID_ARGUMENT' for an environment handle while any connection is in group commit mode, since its
+ * group would end without its writes being told.  End those groups through their connection handles instead.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * If run asynchronously, it may return 'SQL_STILL_EXECUTING'.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcSQLEndTran(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcConnectionState* state = NULL;
+  SQLSMALLINT handleType = SQL_HANDLE_DBC;
+  SQLSMALLINT completion = SQL_COMMIT;
+  SQLUINTEGER i;
+  bool ok = true;
+
+  if (args[0]->ToString() == ndbcSQL_HANDLE_ENV) {
+    handleType = SQL_HANDLE_ENV;
+  } else if (args[0]->ToString() == ndbcSQL_HANDLE_DBC) {
+    handleType = SQL_HANDLE_DBC;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args[2]->ToString() == ndbcSQL_COMMIT) {
+    completion = SQL_COMMIT;
+  } else if (args[2]->ToString() == ndbcSQL_ROLLBACK) {
+    completion = SQL_ROLLBACK;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+
+  if (ok && handleType == SQL_HANDLE_ENV) {
+    for (i = 0; i < 16; i++) {
+      for (state = ndbcConnectionStates[i]; state != NULL; state = state->next) {
+        if (state->groupTimer != NULL) {
+          ok = false;
+          retVal = ndbcINVALID_ARGUMENT;
+        }
+      }
+    }
+    state = NULL;
+  }
+
+  if (ok) {
+    switch (SQLEndTran(handleType, (SQLHANDLE) External::Unwrap(args[1]), completion)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      break;
+    default:
+      if (handleType == SQL_HANDLE_DBC) {
+        state = ndbcGetConnectionState((SQLHANDLE) External::Unwrap(args[1]), false);
+      }
+      if (state != NULL && state->groupTimer != NULL) {
+        ndbcSettleGroup(state, (completion == SQL_COMMIT) ? Handle<Value>(Null()) : Handle<Value>(ndbcSQL_ROLLBACK));
+      }
+      retVal = ndbcSQL_SUCCESS;
+    }
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal function ndbcWriteUnsigned
+ * Writes the decimal representation of value to recData.
+ * Returns the number of bytes written.
+ */
+SQLINTEGER ndbcWriteUnsigned(char* recData, SQLULEN value) {
+  char digits[20];
+  SQLINTEGER n = 0;
+  SQLINTEGER k = 0;
+
+  do {
+    digits[n] = (char) ('0' + value % 10);
+    n++;
+    value /= 10;
+  } while (value > 0);
+  while (n > 0) {
+    n--;
+    recData[k] = digits[n];
+    k++;
+  }
+  return k;
+}
+
+/* ndbc internal function ndbcWriteJsonString
+ * Writes len bytes of text to out as a quoted Json string literal.
+ * " and \ are escaped, other control characters are written as \u escape sequences, and all other bytes are
+ * copied verbatim.
+ * If out is NULL, nothing is written, so the function can be used to size the output first.
+ * Returns the number of bytes written (or that would be written).
+ */
+SQLUINTEGER ndbcWriteJsonString(char* out, const char* data, SQLUINTEGER len) {
+  static const char hex[] = "0123456789abcdef";
+  SQLUINTEGER k = 0;
+  SQLUINTEGER l;
+  unsigned char c;
+
+  if (out == NULL) {
+    k = 2;
+    for (l = 0; l < len; l++) {
+      c = (unsigned char) data[l];
+      k += (c == '\"' || c == '\\') ? 2 : ((c < 32) ? 6 : 1);
+    }
+    return k;
+  }
+  out[k] = '\"';
+  k++;
+  for (l = 0; l < len; l++) {
+    c = (unsigned char) data[l];
+    if (c == '\"' || c == '\\') {
+      out[k] = '\\';
+      k++;
+      out[k] = c;
+      k++;
+    } else if (c < 32) {
+      memcpy(out + k, "\\u00", 4);
+      k += 4;
+      out[k] = hex[c >> 4];
+      k++;
+      out[k] = hex[c & 15];
+      k++;
+    } else {
+      out[k] = c;
+      k++;
+    }
+  }
+  out[k] = '\"';
+  k++;
+  return k;
+}
+
+/* ndbc internal type ndbcRowDesc
+ * The native form of a row description produced by ndbcJsonDescribe.
+ * Allocated as a single block by ndbcNewRowDesc, together with its per-column lists.
+ * columns - The number of output columns.
+ * recLen - The number of bytes required to represent a single row of data in Json format.
+ * dataLen - The number of bytes required to buffer a single row of bound column data.
+ * type - The SQL data type of each column, or SQL_UNKNOWN_TYPE if the description was parsed from text.
+ * precision - The precision each exact decimal column is bound with.  0 for other columns.
+ * scale - The scale each exact decimal column is bound with, or the number of fractional second digits output for
+ *         each timestamp column.  0 for other columns.
+ * column - The result set column number (starting at 1) each output column is bound to.
+ * serialize - The serialization character of each column ('q', 'b', 'n', 'd', 's', 'i' or 'p' for exact decimals,
+ *             'D', 'T', 'S', 'E' or 'M' for dates and times, or 'g' for GUIDs).
+ * colLen - The size of each column's bound buffer.
+ * offset - The position of each column's bound buffer within a row of bound column data.
+ */
+typedef struct {
+  SQLSMALLINT columns;
+  size_t recLen;
+  size_t dataLen;
+  SQLSMALLINT* type;
+  SQLSMALLINT* precision;
+  SQLSMALLINT* scale;
+  SQLUSMALLINT* column;
+  char* serialize;
+  SQLLEN* colLen;
+  size_t* offset;
+} ndbcRowDesc;
+
+/* ndbc internal variable ndbcRowDescClass
+ * Template for the objects that wrap an ndbcRowDesc in javascript.  Created by init.
+ */
+Persistent<FunctionTemplate> ndbcRowDescClass;
+
+/* ndbc internal function ndbcNewRowDesc
+ * Allocates a row description for the given number of columns, with its per-column lists zeroed and each output
+ * column bound to the result set column in the same position.
+ * Returns NULL if memory could not be allocated.
+ */
+ndbcRowDesc* ndbcNewRowDesc(SQLSMALLINT columns) {
+  ndbcRowDesc* desc;
+  SQLSMALLINT j;
+
+  if (columns < 0) {
+    return NULL;
+  }
+  // Lay the lists out after the header in decreasing order of alignment.
+  desc = (ndbcRowDesc*) calloc(1, sizeof(ndbcRowDesc) + (columns * (sizeof(SQLLEN) + sizeof(size_t) + (sizeof(SQLSMALLINT) * 4) + 1)) + 1);
+  if (desc == NULL) {
+    return NULL;
+  }
+  desc->columns = columns;
+  desc->colLen = (SQLLEN*) (desc + 1);
+  desc->offset = (size_t*) (desc->colLen + columns);
+  desc->type = (SQLSMALLINT*) (desc->offset + columns);
+  desc->precision = desc->type + columns;
+  desc->scale = desc->precision + columns;
+  desc->column = (SQLUSMALLINT*) (desc->scale + columns);
+  desc->serialize = (char*) (desc->column + columns);
+  for (j = 0; j < columns; j++) {
+    desc->column[j] = j + 1;
+  }
+  return desc;
+}
+
+/* ndbc internal function ndbcIsDecimal
+ * Returns true if a serialization character is one of those used for columns bound as SQL_NUMERIC_STRUCT.
+ */
+bool ndbcIsDecimal(char serialize) {
+  return serialize == 'd' || serialize == 's' || serialize == 'i' || serialize == 'p';
+}
+
+/* ndbc internal function ndbcBindType
+ * Returns the C data type a column is bound as for a serialization character.
+ * Returns SQL_C_CHAR for the text serializations, whose buffers vary in size; all others are fixed size structures.
+ */
+SQLSMALLINT ndbcBindType(char serialize) {
+  switch (serialize) {
+  case 'd':
+  case 's':
+  case 'i':
+  case 'p':
+    return SQL_C_NUMERIC;
+  case 'D':
+    return SQL_C_TYPE_DATE;
+  case 'T':
+  case 'M':
+    return SQL_C_TYPE_TIME;
+  case 'S':
+  case 'E':
+    return SQL_C_TYPE_TIMESTAMP;
+  case 'g':
+    return SQL_C_GUID;
+  default:
+    return SQL_C_CHAR;
+  }
+}
+
+/* ndbc internal function ndbcBindSize
+ * Returns the size of the structure a column is bound as for a serialization character, or 0 for SQL_C_CHAR.
+ */
+SQLUINTEGER ndbcBindSize(char serialize) {
+  switch (ndbcBindType(serialize)) {
+  case SQL_C_NUMERIC:
+    return sizeof(SQL_NUMERIC_STRUCT);
+  case SQL_C_TYPE_DATE:
+    return sizeof(SQL_DATE_STRUCT);
+  case SQL_C_TYPE_TIME:
+    return sizeof(SQL_TIME_STRUCT);
+  case SQL_C_TYPE_TIMESTAMP:
+    return sizeof(SQL_TIMESTAMP_STRUCT);
+  case SQL_C_GUID:
+    return sizeof(SQLGUID);
+  default:
+    return 0;
+  }
+}
+
+/* ndbc internal function ndbcLayoutRowDesc
+ * Assigns each column of a row description its position within a row of bound column data.
+ * Each column's buffer gets an extra byte for null termination, and columns bound as structures are aligned to 8 bytes.
+ * Returns false if a column length is negative or the row would be longer than ndbcMaxLength.
+ */
+bool ndbcLayoutRowDesc(ndbcRowDesc* desc) {
+  SQLSMALLINT j;
+
+  desc->dataLen = 0;
+  for (j = 0; j < desc->columns; j++) {
+    if (desc->colLen[j] < 0 || (size_t) desc->colLen[j] + 8 > ndbcMaxLength - desc->dataLen) {
+      return false;
+    }
+    if (ndbcBindType(desc->serialize[j]) != SQL_C_CHAR) {
+      desc->dataLen = (desc->dataLen + 7) & ~((size_t) 7);
+    }
+    desc->offset[j] = desc->dataLen;
+    desc->dataLen += desc->colLen[j] + 1;
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcUniqueColumns
+ * Returns true if no two output columns of a row description are bound to the same result set column.
+ * Binding a column again replaces its earlier binding, which would leave an output column without data.
+ */
+bool ndbcUniqueColumns(ndbcRowDesc* desc) {
+  unsigned char seen[4096];
+  SQLSMALLINT j;
+
+  memset(seen, 0, sizeof(seen));
+  for (j = 0; j < desc->columns; j++) {
+    if (seen[(desc->column[j] >> 3) & 4095] & (1 << (desc->column[j] & 7))) {
+      return false;
+    }
+    seen[(desc->column[j] >> 3) & 4095] |= 1 << (desc->column[j] & 7);
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcParseRowDesc
+ * Parses a row description string in the format returned by earlier versions of ndbcJsonDescribe,
+ * eg. "c3l57q20n11n24", or with exact decimal and date / time columns, eg. "c3l91q20s12.2S3".
+ * An output column bound to a different result set column is preceded by '@' and that column's number, eg. "c1l12@4n11".
+ * Returns NULL if the description is invalid or memory could not be allocated.
+ */
+ndbcRowDesc* ndbcParseRowDesc(const char* rowDesc) {
+  ndbcRowDesc* desc;
+  SQLUINTEGER i;
+  SQLSMALLINT j;
+  SQLINTEGER columns = 0;
+  size_t recLen = 0;
+  size_t colLen;
+  SQLINTEGER column;
+
+  if (rowDesc[0] != 'c') {
+    return NULL;
+  }
+  // Extract the column count from rowDesc.
+  for (i = 1; rowDesc[i] > 47 && rowDesc[i] < 58 && columns < 32768; i++) {
+    columns *= 10;
+    columns += rowDesc[i] - 48;
+  }
+  if (rowDesc[i] != 'l' || columns >= 32768) {
+    return NULL;
+  }
+  // Extract the record length from rowDesc, rejecting lengths that do not fit in an SQLLEN.
+  for (i++; rowDesc[i] > 47 && rowDesc[i] < 58 && recLen <= ndbcMaxLength / 10; i++) {
+    recLen *= 10;
+    recLen += rowDesc[i] - 48;
+  }
+  if (recLen > ndbcMaxLength || (rowDesc[i] > 47 && rowDesc[i] < 58)) {
+    return NULL;
+  }
+  desc = ndbcNewRowDesc((SQLSMALLINT) columns);
+  if (desc == NULL) {
+    return NULL;
+  }
+  desc->recLen = recLen;
+  for (j = 0; j < desc->columns; j++) {
+    if (rowDesc[i] == '@') {
+      // Extract the result set column number the output column is bound to.
+      column = 0;
+      for (i++; rowDesc[i] > 47 && rowDesc[i] < 58 && column < 32768; i++) {
+        column *= 10;
+        column += rowDesc[i] - 48;
+      }
+      if (column < 1 || column >= 32768) {
+        free(desc);
+        return NULL;
+      }
+      desc->column[j] = (SQLUSMALLINT) column;
+    }
+    if (rowDesc[i] != 'q' && rowDesc[i] != 'b' && rowDesc[i] != 'n' && ndbcBindType(rowDesc[i]) == SQL_C_CHAR) {
+      // The description ended before all of its columns were described, or is malformed.
+      free(desc);
+      return NULL;
+    }
+    desc->type[j] = SQL_UNKNOWN_TYPE;
+    desc->serialize[j] = rowDesc[i];
+    // Extract the field's buffer size from rowDesc, rejecting sizes that do not fit in an SQLLEN.
+    colLen = 0;
+    for (i++; rowDesc[i] > 47 && rowDesc[i] < 58 && colLen <= ndbcMaxLength / 10; i++) {
+      colLen *= 10;
+      colLen += rowDesc[i] - 48;
+    }
+    if (colLen > ndbcMaxLength || (rowDesc[i] > 47 && rowDesc[i] < 58)) {
+      free(desc);
+      return NULL;
+    }
+    desc->colLen[j] = (SQLLEN) colLen;
+    if (ndbcIsDecimal(desc->serialize[j])) {
+      // Exact decimals give their precision and scale instead, and are bound as a numeric structure.
+      if (rowDesc[i] != '.' || desc->colLen[j] < 1 || desc->colLen[j] > 38) {
+        free(desc);
+        return NULL;
+      }
+      desc->precision[j] = (SQLSMALLINT) desc->colLen[j];
+      for (i++; rowDesc[i] > 47 && rowDesc[i] < 58 && desc->scale[j] <= 38; i++) {
+        desc->scale[j] *= 10;
+        desc->scale[j] += rowDesc[i] - 48;
+      }
+      if (desc->scale[j] > desc->precision[j]) {
+        free(desc);
+        return NULL;
+      }
+      desc->colLen[j] = sizeof(SQL_NUMERIC_STRUCT);
+    } else if (ndbcBindType(desc->serialize[j]) != SQL_C_CHAR) {
+      // Dates and times give the number of fractional second digits to output instead, and GUIDs give 0.
+      if (desc->colLen[j] > 9) {
+        free(desc);
+        return NULL;
+      }
+      desc->scale[j] = (SQLSMALLINT) desc->colLen[j];
+      desc->colLen[j] = ndbcBindSize(desc->serialize[j]);
+    }
+  }
+  if (!ndbcUniqueColumns(desc) || !ndbcLayoutRowDesc(desc)) {
+    free(desc);
+    return NULL;
+  }
+  return desc;
+}
+
+/* ndbc internal function ndbcRowDescText
+ * Sets retVal to a row description in its text form, eg. "c3l57q20n11n24", "c3l91q20s12.2S3" or "c1l12@4n11".
+ * Returns false, with retVal set to the error, if memory could not be allocated.
+ */
+bool ndbcRowDescText(ndbcRowDesc* desc, Local<Value>& retVal) {
+  char textBuf[1024];
+  char* text = textBuf;
+  SQLUINTEGER k = 0;
+  SQLSMALLINT j;
+
+  // Describe typical rows on the stack, and only allocate for very wide ones.
+  if ((size_t) (28 + (desc->columns * 28)) > sizeof(textBuf)) {
+    text = (char*) malloc(28 + (desc->columns * 28));
+    if (text == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      return false;
+    }
+  }
+  text[k] = 'c';
+  k++;
+  k += ndbcWriteUnsigned(text + k, desc->columns);
+  text[k] = 'l';
+  k++;
+  k += ndbcWriteUnsigned(text + k, desc->recLen);
+  for (j = 0; j < desc->columns; j++) {
+    if (desc->column[j] != j + 1) {
+      text[k] = '@';
+      k++;
+      k += ndbcWriteUnsigned(text + k, desc->column[j]);
+    }
+    text[k] = desc->serialize[j];
+    k++;
+    if (ndbcIsDecimal(desc->serialize[j])) {
+      k += ndbcWriteUnsigned(text + k, desc->precision[j]);
+      text[k] = '.';
+      k++;
+      k += ndbcWriteUnsigned(text + k, desc->scale[j]);
+    } else if (ndbcBindType(desc->serialize[j]) != SQL_C_CHAR) {
+      k += ndbcWriteUnsigned(text + k, desc->scale[j]);
+    } else {
+      k += ndbcWriteUnsigned(text + k, desc->colLen[j]);
+    }
+  }
+  retVal = String::New(text, k);
+  if (text != textBuf) {
+    free(text);
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcRowDescWeakCallback
+ * Frees a row description once the javascript object wrapping it has been garbage collected.
+ */
+void ndbcRowDescWeakCallback(Persistent<Value> object, void* parameter) {
+  free(parameter);
+  object.Dispose();
+  object.Clear();
+}
+
+/* ndbc internal function ndbcWrapRowDesc
+ * Sets retVal to a javascript object that wraps a row description and owns it.
+ * The object also carries the description's text form in its rowDesc property.
+ * Returns false, with retVal set to the error and the description still owned by the caller, if the text form could
+ * not be made.
+ */
+bool ndbcWrapRowDesc(ndbcRowDesc* desc, Local<Value>& retVal) {
+  Local<Object> object;
+  Local<Value> text;
+  Persistent<Object> handle;
+
+  if (!ndbcRowDescText(desc, text)) {
+    retVal = text;
+    return false;
+  }
+  object = ndbcRowDescClass->GetFunction()->NewInstance();
+  object->SetPointerInInternalField(0, desc);
+  object->Set(String::NewSymbol("rowDesc"), text);
+  handle = Persistent<Object>::New(object);
+  handle.MakeWeak(desc, ndbcRowDescWeakCallback);
+  retVal = object;
+  return true;
+}
+
+/* ndbc internal function ndbcUnwrapRowDesc
+ * Returns the row description wrapped by a javascript object made by ndbcWrapRowDesc,
+ * or NULL for any other value.
+ */
+ndbcRowDesc* ndbcUnwrapRowDesc(Handle<Value> value) {
+  if (!ndbcRowDescClass->HasInstance(value)) {
+    return NULL;
+  }
+  return (ndbcRowDesc*) value->ToObject()->GetPointerFromInternalField(0);
+}
+
+/* ndbc internal function ndbcResolveRowDesc
+ * Returns the row description wrapped by a descriptor object, or parsed from a row description string.
+ * A description parsed from a string is also returned in parsed, and must be freed by the caller.
+ * Returns NULL if the value is neither.
+ */
+ndbcRowDesc* ndbcResolveRowDesc(Handle<Value> rowDesc, ndbcRowDesc** parsed) {
+  ndbcRowDesc* desc = ndbcUnwrapRowDesc(rowDesc);
+
+  *parsed = NULL;
+  if (desc == NULL) {
+    String::AsciiValue rawVal(rowDesc->ToString());
+    *parsed = ndbcParseRowDesc(*rawVal);
+    desc = *parsed;
+  }
+  return desc;
+}
+
+/* ndbc internal type ndbcRowBuffer
+ * Holds the column buffers that ndbcBindRowDesc binds to a result set.
+ * statement - The statement handle the buffers are bound to.  NULL until binding starts.
+ * parsed - A row description parsed from text for this buffer, owned by the buffer.  NULL if none.
+ * columns - The number of output columns.
+ * recLen - The number of bytes required to represent a single row of data in Json format.
+ * serialize - The serialization character of each column.
+ * scale - The scale of each exact decimal column, or fractional second digits of each timestamp column.
+ * rowData - The output buffer bound to each column, each pointing into the statement's row block.
+ * rowInd - The length / indicator value bound to each column.
+ * rowLen - The size of each column's output buffer.
+ */
+typedef struct {
+  SQLHANDLE statement;
+  ndbcRowDesc* parsed;
+  SQLSMALLINT columns;
+  size_t recLen;
+  char* serialize;
+  SQLSMALLINT* scale;
+  SQLCHAR** rowData;
+  SQLLEN** rowInd;
+  SQLLEN* rowLen;
+} ndbcRowBuffer;
+
+/* ndbc internal function ndbcBindRowDesc
+ * Binds a buffer to each column of the statement's result set as laid out by a row description.
+ * rowDesc may be a descriptor object returned by ndbcJsonDescribe or a row description string.
+ * Returns false and sets retVal to the error string if the description is invalid or binding fails.
+ * The row buffer must be released with ndbcFreeRowBuffer whether or not binding succeeded.
+ */
+bool ndbcBindRowDesc(SQLHANDLE statement, Handle<Value> rowDesc, ndbcRowBuffer* rowBuf, Local<Value>& retVal) {
+  ndbcStatementState* state;
+  ndbcRowDesc* desc;
+  SQLHANDLE appDesc = NULL;
+  SQLCHAR* data;
+  SQLLEN* ind;
+  size_t size;
+  size_t dataStart;
+  SQLSMALLINT j;
+
+  rowBuf->statement = NULL;
+  rowBuf->parsed = NULL;
+  rowBuf->columns = 0;
+  rowBuf->recLen = 0;
+  rowBuf->serialize = NULL;
+  rowBuf->scale = NULL;
+  rowBuf->rowData = NULL;
+  rowBuf->rowInd = NULL;
+  rowBuf->rowLen = NULL;
+
+  desc = ndbcResolveRowDesc(rowDesc, &rowBuf->parsed);
+  if (desc == NULL) {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  rowBuf->columns = desc->columns;
+  rowBuf->recLen = desc->recLen;
+  rowBuf->serialize = desc->serialize;
+  rowBuf->scale = desc->scale;
+  rowBuf->rowLen = desc->colLen;
+
+  // Lay out the column pointers, the indicators and then the column data, aligned to 8 bytes, in one block.
+  // The block belongs to the statement and is reused by each call, growing only when a row needs more room.
+  dataStart = (((sizeof(SQLCHAR*) + sizeof(SQLLEN*) + sizeof(SQLLEN)) * desc->columns) + 7) & ~((size_t) 7);
+  size = dataStart;
+  if (!ndbcAddSize(&size, desc->dataLen) || !ndbcAddSize(&size, 1)) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  state = ndbcGetStatementState(statement, true);
+  if (state == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  // Fetch a single row into the row block.  A rowset bound by BindRowset is released first, along with its rowset
+  // size, which the driver would otherwise fill past the end of the row block.
+  if (state->rowStatus != NULL) {
+    SQLFreeStmt(statement, SQL_UNBIND);
+    ndbcArenaReset(&state->rowset);
+    state->rowStatus = NULL;
+    state->rowsetSize = 0;
+  }
+  SQLSetStmtAttr(statement, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+  SQLSetStmtAttr(statement, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+  if (state->rowBlockSize < size) {
+    free(state->rowBlock);
+    state->rowBlockSize = 0;
+    state->rowBlock = (char*) malloc(size);
+    if (state->rowBlock == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      return false;
+    }
+    state->rowBlockSize = size;
+  }
+  rowBuf->rowData = (SQLCHAR**) state->rowBlock;
+  rowBuf->rowInd = (SQLLEN**) (rowBuf->rowData + desc->columns);
+  ind = (SQLLEN*) (rowBuf->rowInd + desc->columns);
+  data = (SQLCHAR*) (state->rowBlock + dataStart);
+  rowBuf->statement = statement;
+  for (j = 0; j < desc->columns; j++) {
+    rowBuf->rowData[j] = data + desc->offset[j];
+    rowBuf->rowInd[j] = ind + j;
+    // Bind the column output buffer to the result set column, as text or as the structure its serialization reads.
+    switch (SQLBindCol(statement, desc->column[j], ndbcBindType(desc->serialize[j]), (SQLPOINTER) rowBuf->rowData[j], desc->colLen[j], rowBuf->rowInd[j])) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      return false;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      return false;
+    }
+    if (ndbcIsDecimal(desc->serialize[j])) {
+      // Give the row descriptor the precision and scale to convert exact decimals to.
+      // Setting those fields unbinds the column, so the data pointer is set again last.
+      if (appDesc == NULL && SQLGetStmtAttr(statement, SQL_ATTR_APP_ROW_DESC, &appDesc, 0, NULL) == SQL_ERROR) {
+        retVal = ndbcSQL_ERROR;
+        return false;
+      }
+      if (SQLSetDescField(appDesc, desc->column[j], SQL_DESC_TYPE, (SQLPOINTER) SQL_C_NUMERIC, 0) == SQL_ERROR
+          || SQLSetDescField(appDesc, desc->column[j], SQL_DESC_PRECISION, (SQLPOINTER) (SQLLEN) desc->precision[j], 0) == SQL_ERROR
+          || SQLSetDescField(appDesc, desc->column[j], SQL_DESC_SCALE, (SQLPOINTER) (SQLLEN) desc->scale[j], 0) == SQL_ERROR
+          || SQLSetDescField(appDesc, desc->column[j], SQL_DESC_DATA_PTR, (SQLPOINTER) rowBuf->rowData[j], 0) == SQL_ERROR) {
+        retVal = ndbcSQL_ERROR;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcFreeRowBuffer
+ * Unbinds the column buffers bound by ndbcBindRowDesc and releases any row description it parsed.
+ * Unbinding keeps later fetches on the statement from writing into the row block while it is reused or freed.
+ */
+void ndbcFreeRowBuffer(ndbcRowBuffer* rowBuf) {
+  if (rowBuf->statement != NULL) {
+    SQLFreeStmt(rowBuf->statement, SQL_UNBIND);
+  }
+  free(rowBuf->parsed);
+}
+
+/* ndbc internal function ndbcFieldInd
+ * Returns the length of the data actually held in column j of a bound row buffer, given its length / indicator value.
+ * Null data stays SQL_NULL_DATA, columns bound as structures always fill them, and truncated or unknown
+ * lengths are limited to the bound buffer, less the null terminator.
+ */
+SQLLEN ndbcFieldInd(ndbcRowBuffer* rowBuf, SQLUSMALLINT j, SQLLEN rowInd) {
+  if (rowInd == SQL_NULL_DATA) {
+    return rowInd;
+  }
+  if (ndbcBindType(rowBuf->serialize[j]) != SQL_C_CHAR) {
+    return rowBuf->rowLen[j];
+  }
+  if (rowInd < 0 || rowInd >= rowBuf->rowLen[j]) {
+    return (rowBuf->rowLen[j] > 0) ? rowBuf->rowLen[j] - 1 : 0;
+  }
+  return rowInd;
+}
+
+/* ndbc internal function ndbcWriteDecimal
+ * Writes an exact decimal value held in a numeric structure to out in Json format.
+ * scale - The number of digits to place after the decimal point (0 to 38).
+ * serialize - 'd' for an unquoted number, 's' for a quoted number, 'i' for the quoted unscaled integer (the value
+ *             multiplied by 10 to the power of scale), or 'p' for the unscaled integer as an array of its signed high
+ *             and unsigned low 32 bits.  'p' falls back to 'i' for values that do not fit in 64 bits.
+ * Writes at most 43 bytes.
+ * Returns the number of bytes written.
+ */
+SQLINTEGER ndbcWriteDecimal(char* out, SQL_NUMERIC_STRUCT* number, SQLSMALLINT scale, char serialize) {
+  SQLUINTEGER limb[4];
+  char digit[48];
+  SQLINTEGER digits = 0;
+  SQLINTEGER k = 0;
+  SQLINTEGER l;
+  SQLINTEGER i;
+  SQLUBIGINT remainder;
+  SQLUBIGINT value;
+  bool negative;
+
+  // Read the little endian 128 bit magnitude into 32 bit limbs, most significant last.
+  for (l = 0; l < 4; l++) {
+    limb[l] = number->val[l * 4] | (number->val[(l * 4) + 1] << 8) | (number->val[(l * 4) + 2] << 16)
+            | ((SQLUINTEGER) number->val[(l * 4) + 3] << 24);
+  }
+  negative = (number->sign == 0) && (limb[0] | limb[1] | limb[2] | limb[3]) != 0;
+
+  if (serialize == 'p' && limb[2] == 0 && limb[3] == 0) {
+    value = ((SQLUBIGINT) limb[1] << 32) | limb[0];
+    if (value < ((SQLUBIGINT) 1 << 63) || (negative && value == ((SQLUBIGINT) 1 << 63))) {
+      // Two's complement the magnitude for negative values, then split it into its signed high and unsigned low halves.
+      if (negative) {
+        value = ~value + 1;
+      }
+      out[k] = '[';
+      k++;
+      if ((SQLINTEGER) (value >> 32) < 0) {
+        out[k] = '-';
+        k++;
+        k += ndbcWriteUnsigned(out + k, 0 - (SQLUINTEGER) (value >> 32));
+      } else {
+        k += ndbcWriteUnsigned(out + k, (SQLUINTEGER) (value >> 32));
+      }
+      out[k] = ',';
+      k++;
+      k += ndbcWriteUnsigned(out + k, (SQLUINTEGER) value);
+      out[k] = ']';
+      k++;
+      return k;
+    }
+  }
+
+  // Divide the magnitude by 10^9 until nothing is left, collecting nine decimal digits from each remainder,
+  // least significant first.
+  while (limb[0] | limb[1] | limb[2] | limb[3]) {
+    remainder = 0;
+    for (l = 3; l >= 0; l--) {
+      remainder = (remainder << 32) | limb[l];
+      limb[l] = (SQLUINTEGER) (remainder / 1000000000);
+      remainder %= 1000000000;
+    }
+    for (i = 0; i < 9 && (remainder > 0 || (limb[0] | limb[1] | limb[2] | limb[3])); i++) {
+      digit[digits] = '0' + (char) (remainder % 10);
+      digits++;
+      remainder /= 10;
+    }
+  }
+  if (scale < 0 || serialize == 'i' || serialize == 'p') {
+    scale = 0;
+  }
+  // Pad with zeros so there is at least one digit before the decimal point.
+  while (digits <= scale) {
+    digit[digits] = '0';
+    digits++;
+  }
+
+  if (serialize != 'd') {
+    out[k] = '\"';
+    k++;
+  }
+  if (negative) {
+    out[k] = '-';
+    k++;
+  }
+  for (i = digits - 1; i >= 0; i--) {
+    out[k] = digit[i];
+    k++;
+    if (i == scale && i > 0) {
+      out[k] = '.';
+      k++;
+    }
+  }
+  if (serialize != 'd') {
+    out[k] = '\"';
+    k++;
+  }
+  return k;
+}
+
+/* ndbc internal function ndbcWritePadded
+ * Writes the low width digits of value to out, padded with leading zeros.
+ * Returns the number of bytes written (width).
+ */
+SQLINTEGER ndbcWritePadded(char* out, SQLUINTEGER value, SQLINTEGER width) {
+  SQLINTEGER k;
+
+  for (k = width - 1; k >= 0; k--) {
+    out[k] = (char) ('0' + value % 10);
+    value /= 10;
+  }
+  return width;
+}
+
+/* ndbc internal function ndbcWriteDateTime
+ * Writes a date, time or timestamp held in its ODBC structure to out in Json format.
+ * scale - The number of fractional second digits to write for a timestamp (0 to 9).
+ * serialize - 'D', 'T' or 'S' for a quoted ISO-8601 date ("2012-07-28"), time ("13:45:00") or timestamp
+ *             ("2012-07-28T13:45:00.250"), 'E' for a timestamp as unquoted milliseconds since 1970-01-01T00:00:00,
+ *             or 'M' for a time as unquoted milliseconds since midnight.
+ *             Dates and times have no time zone, so epoch milliseconds treat them as UTC.
+ * Writes at most 33 bytes.
+ * Returns the number of bytes written.
+ */
+SQLINTEGER ndbcWriteDateTime(char* out, SQLCHAR* data, SQLSMALLINT scale, char serialize) {
+  SQL_TIMESTAMP_STRUCT* stamp = (SQL_TIMESTAMP_STRUCT*) data;
+  SQL_DATE_STRUCT* date = (SQL_DATE_STRUCT*) data;
+  SQL_TIME_STRUCT* clock = (SQL_TIME_STRUCT*) data;
+  SQLINTEGER k = 0;
+  SQLBIGINT year;
+  SQLBIGINT era;
+  SQLBIGINT days;
+  SQLBIGINT ms;
+  SQLUBIGINT magnitude;
+  char digit[20];
+  SQLINTEGER digits = 0;
+
+  switch (serialize) {
+  case 'E':
+  case 'M':
+    if (serialize == 'E') {
+      // Count days from the civil date, using 400 year eras starting in March so leap days fall at the end of the year.
+      year = stamp->year - ((stamp->month <= 2) ? 1 : 0);
+      era = ((year >= 0) ? year : year - 399) / 400;
+      days = (era * 146097) + ((year - (era * 400)) * 365) + ((year - (era * 400)) / 4) - ((year - (era * 400)) / 100)
+           + (((153 * (stamp->month + ((stamp->month > 2) ? -3 : 9))) + 2) / 5) + stamp->day - 1 - 719468;
+      ms = (days * 86400000) + ((SQLBIGINT) stamp->hour * 3600000) + ((SQLBIGINT) stamp->minute * 60000)
+         + ((SQLBIGINT) stamp->second * 1000) + (stamp->fraction / 1000000);
+    } else {
+      ms = ((SQLBIGINT) clock->hour * 3600000) + ((SQLBIGINT) clock->minute * 60000) + ((SQLBIGINT) clock->second * 1000);
+    }
+    if (ms < 0) {
+      out[k] = '-';
+      k++;
+      magnitude = 0 - (SQLUBIGINT) ms;
+    } else {
+      magnitude = (SQLUBIGINT) ms;
+    }
+    do {
+      digit[digits] = (char) ('0' + magnitude % 10);
+      digits++;
+      magnitude /= 10;
+    } while (magnitude > 0);
+    while (digits > 0) {
+      digits--;
+      out[k] = digit[digits];
+      k++;
+    }
+    return k;
+  }
+
+  out[k] = '\"';
+  k++;
+  if (serialize == 'D' || serialize == 'S') {
+    // Years are written with at least 4 digits, and a sign if they are before year 0.
+    if (date->year < 0) {
+      out[k] = '-';
+      k++;
+    }
+    k += ndbcWritePadded(out + k, (date->year < 0) ? 0 - date->year : date->year, (date->year > 9999 || date->year < -9999) ? 5 : 4);
+    out[k] = '-';
+    k++;
+    k += ndbcWritePadded(out + k, date->month, 2);
+    out[k] = '-';
+    k++;
+    k += ndbcWritePadded(out + k, date->day, 2);
+  }
+  if (serialize == 'S') {
+    out[k] = 'T';
+    k++;
+    k += ndbcWritePadded(out + k, stamp->hour, 2);
+    out[k] = ':';
+    k++;
+    k += ndbcWritePadded(out + k, stamp->minute, 2);
+    out[k] = ':';
+    k++;
+    k += ndbcWritePadded(out + k, stamp->second, 2);
+    if (scale > 0) {
+      // The fraction is in nanoseconds; keep its leading digits.
+      out[k] = '.';
+      k++;
+      ndbcWritePadded(digit, stamp->fraction, 9);
+      memcpy(out + k, digit, (scale < 9) ? scale : 9);
+      k += (scale < 9) ? scale : 9;
+    }
+  } else if (serialize == 'T') {
+    k += ndbcWritePadded(out + k, clock->hour, 2);
+    out[k] = ':';
+    k++;
+    k += ndbcWritePadded(out + k, clock->minute, 2);
+    out[k] = ':';
+    k++;
+    k += ndbcWritePadded(out + k, clock->second, 2);
+  }
+  out[k] = '\"';
+  k++;
+  return k;
+}
+
+/* ndbc internal variable ndbcHexPairs
+ * The two lower case hexadecimal digits of each byte value, so bytes are formatted with one lookup each.
+ */
+const char ndbcHexPairs[] =
+  "000102030405060708090a0b0c0d0e0f"
+  "101112131415161718191a1b1c1d1e1f"
+  "202122232425262728292a2b2c2d2e2f"
+  "303132333435363738393a3b3c3d3e3f"
+  "404142434445464748494a4b4c4d4e4f"
+  "505152535455565758595a5b5c5d5e5f"
+  "606162636465666768696a6b6c6d6e6f"
+  "707172737475767778797a7b7c7d7e7f"
+  "808182838485868788898a8b8c8d8e8f"
+  "909192939495969798999a9b9c9d9e9f"
+  "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+  "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+  "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+  "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+  "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+  "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/* ndbc internal function ndbcWriteGuid
+ * Writes a GUID held in its ODBC structure to out as a quoted string in the canonical 8-4-4-4-12 form,
+ * eg. "6ba7b810-9dad-11d1-80b4-00c04fd430c8".
+ * Writes 38 bytes.
+ * Returns the number of bytes written.
+ */
+SQLINTEGER ndbcWriteGuid(char* out, SQLGUID* guid) {
+  SQLCHAR bytes[16];
+  SQLINTEGER k = 0;
+  SQLINTEGER l;
+
+  // Put the bytes in display order: the first three fields are numbers, written most significant byte first.
+  bytes[0] = (SQLCHAR) (guid->Data1 >> 24);
+  bytes[1] = (SQLCHAR) (guid->Data1 >> 16);
+  bytes[2] = (SQLCHAR) (guid->Data1 >> 8);
+  bytes[3] = (SQLCHAR) guid->Data1;
+  bytes[4] = (SQLCHAR) (guid->Data2 >> 8);
+  bytes[5] = (SQLCHAR) guid->Data2;
+  bytes[6] = (SQLCHAR) (guid->Data3 >> 8);
+  bytes[7] = (SQLCHAR) guid->Data3;
+  memcpy(bytes + 8, guid->Data4, 8);
+
+  out[k] = '\"';
+  k++;
+  for (l = 0; l < 16; l++) {
+    if (l == 4 || l == 6 || l == 8 || l == 10) {
+      out[k] = '-';
+      k++;
+    }
+    out[k] = ndbcHexPairs[bytes[l] * 2];
+    out[k + 1] = ndbcHexPairs[(bytes[l] * 2) + 1];
+    k += 2;
+  }
+  out[k] = '\"';
+  k++;
+  return k;
+}
+
+/* ndbc internal function ndbcWriteField
+ * Writes the current row's value for column j of a bound row buffer to recData in Json format.
+ * The caller must ensure recData has room for the column's share of the row description's record length.
+ * Returns the number of bytes written.
+ */
+size_t ndbcWriteField(char* recData, ndbcRowBuffer* rowBuf, SQLUSMALLINT j) {
+  size_t k = 0;
+  SQLLEN l;
+  SQLCHAR* rowData = rowBuf->rowData[j];
+  SQLLEN rowInd = ndbcFieldInd(rowBuf, j, *rowBuf->rowInd[j]);
+
+  // Check for nulls.
+  if (rowInd == SQL_NULL_DATA) {
+    recData[k] = 'n';
+    k++;
+    recData[k] = 'u';
+    k++;
+    recData[k] = 'l';
+    k++;
+    recData[k] = 'l';
+    k++;
+    return k;
+  }
+  switch (rowBuf->serialize[j]) {
+  case 'q':
+    recData[k] = '\"';
+    k++;
+    // Transcribe text data using escape sequences and discarding control characters.
+    for (l = 0; l < rowInd; l++) {
+      if (rowData[l] < 32 || (rowData[l] > 126 && rowData[l] < 160)) {
+        // Map non-printable characters to spaces.
+        recData[k] = ' ';
+        k++;
+      } else if (rowData[l] == '\"' || rowData[l] == '\\') {
+        // Apply escape sequence to " and \ characters.
+        recData[k] = '\\';
+        k++;
+        recData[k] = rowData[l];
+        k++;
+      } else {
+        // Copy other data over verbatim.
+        recData[k] = rowData[l];
+        k++;
+      }
+    }
+    recData[k] = '\"';
+    k++;
+    break;
+  case 'b':
+    recData[k] = '\"';
+    k++;
+    // Transcribe binary data using base64 encoding.
+    recData[k] = '\"';
+    k++;
+    break;
+  case 'n':
+    // Transcribe numeric data verbatim.
+    for (l = 0; l < rowInd; l++) {
+      recData[k] = rowData[l];
+      k++;
+    }
+    break;
+  case 'd':
+  case 's':
+  case 'i':
+  case 'p':
+    // Format exact decimals from their numeric structure.
+    k += ndbcWriteDecimal(recData + k, (SQL_NUMERIC_STRUCT*) rowData, rowBuf->scale[j], rowBuf->serialize[j]);
+    break;
+  case 'D':
+  case 'T':
+  case 'S':
+  case 'E':
+  case 'M':
+    // Format dates and times from their structures.
+    k += ndbcWriteDateTime(recData + k, rowData, rowBuf->scale[j], rowBuf->serialize[j]);
+    break;
+  case 'g':
+    // Format GUIDs from their structure.
+    k += ndbcWriteGuid(recData + k, (SQLGUID*) rowData);
+  }
+  return k;
+}
+
+/* ndbc internal function ndbcWriteRow
+ * Writes the current row of a bound row buffer to recData as a Json array, preceded by a comma.
+ * The caller must ensure recData has room for the row description's record length.
+ * Returns the number of bytes written.
+ */
+size_t ndbcWriteRow(char* recData, ndbcRowBuffer* rowBuf) {
+  size_t k = 0;
+  SQLUSMALLINT j;
+
+  // Write a preceding comma and begin the row array.
+  recData[k] = ',';
+  k++;
+  recData[k] = '[';
+  k++;
+  // Write the data array to the output.
+  for (j = 0; j < rowBuf->columns; j++) {
+    k += ndbcWriteField(recData + k, rowBuf, j);
+    recData[k] = ',';
+    k++;
+  }
+  // Overwrite the last comma and terminate the row array.
+  recData[k-1] = ']';
+  return k;
+}
+
+/* ndbc internal function ndbcHoldRow
+ * Copies the current row of a bound row buffer into the statement's state, so the next call on the statement
+ * returns it before fetching again.
+ * Returns false if memory could not be allocated.
+ */
+bool ndbcHoldRow(SQLHANDLE statement, ndbcRowBuffer* rowBuf) {
+  ndbcStatementState* state = ndbcGetStatementState(statement, true);
+  size_t size = 0;
+  size_t k = 0;
+  SQLUSMALLINT j;
+  SQLLEN rowInd;
+
+  if (state == NULL) {
+    return false;
+  }
+  // Keep only what ndbcWriteField would output: nothing for nulls and at most the bound buffer for truncated data.
+  for (j = 0; j < rowBuf->columns; j++) {
+    rowInd = ndbcFieldInd(rowBuf, j, *rowBuf->rowInd[j]);
+    size += sizeof(SQLLEN) + ((rowInd > 0) ? rowInd : 0);
+  }
+  free(state->heldRow);
+  state->heldRow = (char*) malloc((size > 0) ? size : 1);
+  if (state->heldRow == NULL) {
+    return false;
+  }
+  state->heldColumns = rowBuf->columns;
+  for (j = 0; j < rowBuf->columns; j++) {
+    rowInd = ndbcFieldInd(rowBuf, j, *rowBuf->rowInd[j]);
+    memcpy(state->heldRow + k, &rowInd, sizeof(SQLLEN));
+    k += sizeof(SQLLEN);
+    if (rowInd > 0) {
+      memcpy(state->heldRow + k, rowBuf->rowData[j], rowInd);
+      k += rowInd;
+    }
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcFetch
+ * Moves a bound row buffer to the next row of the result set.
+ * A row held back by ndbcHoldRow is copied into the buffer and released instead of fetching a new row.
+ * Returns SQLFetch's return value, or SQL_SUCCESS for a held row.
+ * Returns SQL_ERROR if the held row does not have the same number of columns as the buffer.
+ */
+SQLRETURN ndbcFetch(SQLHANDLE statement, ndbcRowBuffer* rowBuf) {
+  ndbcStatementState* state = ndbcGetStatementState(statement, false);
+  size_t k = 0;
+  SQLUSMALLINT j;
+  SQLLEN rowInd;
+  SQLLEN len;
+
+  if (state == NULL || state->heldRow == NULL) {
+    return SQLFetch(statement);
+  }
+  if (state->heldColumns != rowBuf->columns) {
+    return SQL_ERROR;
+  }
+  for (j = 0; j < rowBuf->columns; j++) {
+    memcpy(&rowInd, state->heldRow + k, sizeof(SQLLEN));
+    k += sizeof(SQLLEN);
+    if (rowInd > 0) {
+      // Truncate to the bound buffer, which may be smaller if the row description has changed.
+      len = ndbcFieldInd(rowBuf, j, rowInd);
+      if (len > rowInd) {
+        // A structure is filled from a shorter held value; clear what the value does not cover.
+        memset(rowBuf->rowData[j], 0, len);
+        len = rowInd;
+      }
+      memcpy(rowBuf->rowData[j], state->heldRow + k, len);
+      rowBuf->rowData[j][len] = 0;
+      k += rowInd;
+    }
+    *rowBuf->rowInd[j] = rowInd;
+  }
+  free(state->heldRow);
+  state->heldRow = NULL;
+  return SQL_SUCCESS;
+}
+
+/* ndbc internal function ndbcFetchScroll
+ * Moves a bound row buffer to the row of the result set given by a fetch orientation and offset, as SQLFetchScroll.
+ * SQL_FETCH_NEXT behaves as ndbcFetch.  Any other orientation discards a row held back by ndbcHoldRow, since the
+ * cursor position it was held at no longer applies.
+ * Returns SQLFetchScroll's return value.
+ */
+SQLRETURN ndbcFetchScroll(SQLHANDLE statement, ndbcRowBuffer* rowBuf, SQLSMALLINT orientation, SQLLEN offset) {
+  ndbcStatementState* state;
+
+  if (orientation == SQL_FETCH_NEXT) {
+    return ndbcFetch(statement, rowBuf);
+  }
+  state = ndbcGetStatementState(statement, false);
+  if (state != NULL && state->heldRow != NULL) {
+    free(state->heldRow);
+    state->heldRow = NULL;
+  }
+  return SQLFetchScroll(statement, orientation, offset);
+}
+
+/* ndbc internal function ndbcEpochTimestamp
+ * Fills a timestamp structure from a javascript Date value, in milliseconds since 1970-01-01T00:00:00 UTC.
+ * The timestamp has no time zone, so it is filled in UTC, as ndbcWriteDateTime's epoch milliseconds are read.
+ */
+void ndbcEpochTimestamp(double time, SQL_TIMESTAMP_STRUCT* stamp) {
+  SQLBIGINT ms = (SQLBIGINT) time;
+  SQLBIGINT days;
+  SQLBIGINT era;
+  SQLBIGINT dayOfEra;
+  SQLBIGINT yearOfEra;
+  SQLBIGINT dayOfYear;
+  SQLBIGINT month;
+
+  days = ms / 86400000;
+  ms %= 86400000;
+  if (ms < 0) {
+    ms += 86400000;
+    days--;
+  }
+  // Find the civil date from the day count, using 400 year eras starting in March so leap days fall at the end of
+  // the year.
+  days += 719468;
+  era = ((days >= 0) ? days : days - 146096) / 146097;
+  dayOfEra = days - (era * 146097);
+  yearOfEra = (dayOfEra - (dayOfEra / 1460) + (dayOfEra / 36524) - (dayOfEra / 146096)) / 365;
+  dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+  month = ((5 * dayOfYear) + 2) / 153;
+  stamp->day = (SQLUSMALLINT) (dayOfYear - (((153 * month) + 2) / 5) + 1);
+  stamp->month = (SQLUSMALLINT) ((month < 10) ? month + 3 : month - 9);
+  stamp->year = (SQLSMALLINT) (yearOfEra + (era * 400) + ((stamp->month <= 2) ? 1 : 0));
+  stamp->hour = (SQLUSMALLINT) (ms / 3600000);
+  stamp->minute = (SQLUSMALLINT) ((ms / 60000) % 60);
+  stamp->second = (SQLUSMALLINT) ((ms / 1000) % 60);
+  stamp->fraction = (SQLUINTEGER) ((ms % 1000) * 1000000);
+}
+
+/* ndbc internal function ndbcParamKind
+ * Returns the character for how a javascript value is bound as a parameter: 'n' for null or undefined, 'b' for a
+ * boolean (BIT), 'i' for a 32 bit integer (INTEGER), 'l' for another integer that a double holds exactly (BIGINT),
+ * 'd' for any other number (DOUBLE), 'q' for a string (VARCHAR), 'x' for a Buffer (VARBINARY) or 't' for a Date
+ * (TIMESTAMP).
+ * Returns 0 for values of any other type, which can not be bound.
+ */
+char ndbcParamKind(Local<Value> value) {
+  double number;
+
+  if (value->IsNull() || value->IsUndefined()) {
+    return 'n';
+  } else if (value->IsBoolean()) {
+    return 'b';
+  } else if (value->IsInt32()) {
+    return 'i';
+  } else if (value->IsNumber()) {
+    number = value->NumberValue();
+    if (number >= -9007199254740992.0 && number <= 9007199254740992.0 && (double) (SQLBIGINT) number == number) {
+      return 'l';
+    }
+    return 'd';
+  } else if (value->IsString()) {
+    return 'q';
+  } else if (node::Buffer::HasInstance(value)) {
+    return 'x';
+  } else if (value->IsDate() && value->NumberValue() == value->NumberValue()) {
+    return 't';
+  }
+  return 0;
+}
+
+/* ndbc internal function ndbcWidenParamKind
+ * Returns the parameter kind that holds values of both kinds, so a column of values can be bound with one type.
+ * Nulls fit any kind, and numbers widen from INTEGER to BIGINT to DOUBLE.
+ * Returns 0 if the kinds can not share a type.
+ */
+char ndbcWidenParamKind(char kind, char other) {
+  if (kind == other || other == 'n') {
+    return kind;
+  }
+  if (kind == 'n') {
+    return other;
+  }
+  if ((kind == 'i' || kind == 'l' || kind == 'd') && (other == 'i' || other == 'l' || other == 'd')) {
+    return (kind == 'd' || other == 'd') ? 'd' : 'l';
+  }
+  return 0;
+}
+
+/* ndbc internal function ndbcBindParamArrays
+ * Binds rows <first> to <first> + <count> - 1 of a javascript array of rows as arrays of input parameters, so a
+ * single execution of the statement runs once for each row.
+ * If rowset is true, binds the rows as the columns of a rowset instead (SQLBindCol), for SQLBulkOperations and
+ * SQLSetPos to write.  The rowset's values and row status array are then kept in the state's rowset and rowStatus.
+ * Each row is an array holding a value for each parameter marker, in order.  Every row must have the same number of
+ * values, and the values for each parameter must share a kind (see ndbcParamKind), apart from nulls and numbers.
+ * Parameters are bound column-wise, each as one block of <count> values sized to the largest value in the rows.
+ * Values are copied into the statement's state, where they stay until parameters are next bound, so every execution
+ * of the statement in between can read them.  Any earlier parameter bindings are released first.
+ * The statement's parameter status array and processed count point into the state, at paramStatus and
+ * paramsProcessed.
+ * Returns false and sets retVal to the error string if the rows are invalid or binding fails.
+ */
+bool ndbcBindParamArrays(SQLHANDLE statement, Local<Array> rows, SQLUINTEGER first, SQLUINTEGER count,
+                         bool rowset, Local<Value>& retVal) {
+  ndbcStatementState* state;
+  ndbcArena* arena;
+  Local<Value> row;
+  Local<Value> value;
+  SQLUINTEGER columns;
+  SQLUINTEGER i;
+  SQLUINTEGER r;
+  char* kind;
+  size_t* width;
+  SQLSMALLINT cType;
+  SQLSMALLINT sqlType;
+  SQLSMALLINT digits;
+  SQLULEN size;
+  size_t cell;
+  size_t len;
+  char* data;
+  SQLLEN* ind;
+  SQLRETURN status;
+
+  row = rows->Get(first);
+  if (count < 1 || !row->IsArray() || Local<Array>::Cast(row)->Length() > 32767) {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  columns = Local<Array>::Cast(row)->Length();
+  state = ndbcGetStatementState(statement, true);
+  if (state == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  // Release the earlier bindings before the memory they point to is reused.
+  if (rowset) {
+    arena = &state->rowset;
+    SQLFreeStmt(statement, SQL_UNBIND);
+    ndbcArenaReset(arena);
+    state->rowStatus = (SQLUSMALLINT*) ndbcArenaAlloc(arena, sizeof(SQLUSMALLINT) * count);
+    state->rowsetSize = count;
+  } else {
+    arena = &state->params;
+    SQLFreeStmt(statement, SQL_RESET_PARAMS);
+    ndbcArenaReset(arena);
+    state->paramStatus = (SQLUSMALLINT*) ndbcArenaAlloc(arena, sizeof(SQLUSMALLINT) * count);
+    state->paramsProcessed = (SQLULEN*) ndbcArenaAlloc(arena, sizeof(SQLULEN));
+  }
+  kind = ndbcArenaAlloc(arena, columns + 1);
+  width = (size_t*) ndbcArenaAlloc(arena, sizeof(size_t) * (columns + 1));
+  if ((rowset ? state->rowStatus == NULL : (state->paramStatus == NULL || state->paramsProcessed == NULL))
+      || kind == NULL || width == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  memset(kind, 'n', columns);
+  memset(width, 0, sizeof(size_t) * columns);
+
+  // Find the kind of each parameter across the rows, and the length of its longest string or Buffer.
+  for (r = first; r < first + count; r++) {
+    row = rows->Get(r);
+    if (!row->IsArray() || Local<Array>::Cast(row)->Length() != columns) {
+      retVal = ndbcINVALID_ARGUMENT;
+      return false;
+    }
+    for (i = 0; i < columns; i++) {
+      value = Local<Array>::Cast(row)->Get(i);
+      kind[i] = ndbcWidenParamKind(kind[i], ndbcParamKind(value));
+      if (kind[i] == 0) {
+        retVal = ndbcINVALID_ARGUMENT;
+        return false;
+      }
+      if (value->IsString()) {
+        len = value->ToString()->Utf8Length();
+      } else if (node::Buffer::HasInstance(value)) {
+        len = node::Buffer::Length(value->ToObject());
+      } else {
+        len = 0;
+      }
+      if (len > width[i]) {
+        width[i] = len;
+      }
+    }
+  }
+
+  // Size the parameter set or rowset to the rows.  Drivers without arrays can still bind a single row.
+  if (rowset) {
+    if (SQLSetStmtAttr(statement, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER) SQL_BIND_BY_COLUMN, 0) == SQL_ERROR
+        || SQLSetStmtAttr(statement, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) (SQLULEN) count, 0) == SQL_ERROR) {
+      if (count > 1) {
+        retVal = ndbcSQL_ERROR;
+        return false;
+      }
+    }
+    SQLSetStmtAttr(statement, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) state->rowStatus, 0);
+  } else {
+    if (SQLSetStmtAttr(statement, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0) == SQL_ERROR
+        || SQLSetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (SQLULEN) count, 0) == SQL_ERROR) {
+      if (count > 1) {
+        retVal = ndbcSQL_ERROR;
+        return false;
+      }
+    }
+    SQLSetStmtAttr(statement, SQL_ATTR_PARAM_STATUS_PTR, (SQLPOINTER) state->paramStatus, 0);
+    SQLSetStmtAttr(statement, SQL_ATTR_PARAMS_PROCESSED_PTR, (SQLPOINTER) state->paramsProcessed, 0);
+  }
+
+  // Copy each parameter's values into one block and bind it.
+  for (i = 0; i < columns; i++) {
+    digits = 0;
+    switch (kind[i]) {
+    case 'b':
+      cType = SQL_C_BIT;
+      sqlType = SQL_BIT;
+      size = 1;
+      cell = sizeof(SQLCHAR);
+      break;
+    case 'i':
+      cType = SQL_C_SLONG;
+      sqlType = SQL_INTEGER;
+      size = 10;
+      cell = sizeof(SQLINTEGER);
+      break;
+    case 'l':
+      cType = SQL_C_SBIGINT;
+      sqlType = SQL_BIGINT;
+      size = 19;
+      cell = sizeof(SQLBIGINT);
+      break;
+    case 'd':
+      cType = SQL_C_DOUBLE;
+      sqlType = SQL_DOUBLE;
+      size = 15;
+      cell = sizeof(double);
+      break;
+    case 'q':
+      // Leave room for a null terminator, and use the long type past the usual VARCHAR limit.
+      cType = SQL_C_CHAR;
+      sqlType = (width[i] > 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR;
+      size = (width[i] > 0) ? width[i] : 1;
+      cell = width[i] + 1;
+      break;
+    case 'x':
+      cType = SQL_C_BINARY;
+      sqlType = (width[i] > 8000) ? SQL_LONGVARBINARY : SQL_VARBINARY;
+      size = (width[i] > 0) ? width[i] : 1;
+      cell = (width[i] > 0) ? width[i] : 1;
+      break;
+    case 't':
+      cType = SQL_C_TYPE_TIMESTAMP;
+      sqlType = SQL_TYPE_TIMESTAMP;
+      size = 23;
+      digits = 3;
+      cell = sizeof(SQL_TIMESTAMP_STRUCT);
+      break;
+    default:
+      // A parameter that is null in every row.
+      cType = SQL_C_CHAR;
+      sqlType = SQL_VARCHAR;
+      size = 1;
+      cell = 1;
+    }
+    if (cell > ndbcMaxLength / count) {
+      retVal = ndbcINTERNAL_ERROR;
+      return false;
+    }
+    data = ndbcArenaAlloc(arena, cell * count);
+    ind = (SQLLEN*) ndbcArenaAlloc(arena, sizeof(SQLLEN) * count);
+    if (data == NULL || ind == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      return false;
+    }
+    for (r = 0; r < count; r++) {
+      value = Local<Array>::Cast(rows->Get(first + r))->Get(i);
+      if (value->IsNull() || value->IsUndefined()) {
+        ind[r] = SQL_NULL_DATA;
+        continue;
+      }
+      ind[r] = (SQLLEN) cell;
+      switch (kind[i]) {
+      case 'b':
+        *(SQLCHAR*) (data + (r * cell)) = value->BooleanValue() ? 1 : 0;
+        break;
+      case 'i':
+        *(SQLINTEGER*) (data + (r * cell)) = value->Int32Value();
+        break;
+      case 'l':
+        *(SQLBIGINT*) (data + (r * cell)) = (SQLBIGINT) value->NumberValue();
+        break;
+      case 'd':
+        *(double*) (data + (r * cell)) = value->NumberValue();
+        break;
+      case 'q':
+        ind[r] = value->ToString()->WriteUtf8(data + (r * cell), (int) width[i], NULL, String::NO_NULL_TERMINATION);
+        data[(r * cell) + ind[r]] = 0;
+        break;
+      case 'x':
+        ind[r] = node::Buffer::Length(value->ToObject());
+        memcpy(data + (r * cell), node::Buffer::Data(value->ToObject()), ind[r]);
+        break;
+      case 't':
+        ndbcEpochTimestamp(value->NumberValue(), (SQL_TIMESTAMP_STRUCT*) (data + (r * cell)));
+      }
+    }
+    if (rowset) {
+      status = SQLBindCol(statement, (SQLUSMALLINT) (i + 1), cType, (SQLPOINTER) data, (SQLLEN) cell, ind);
+    } else {
+      status = SQLBindParameter(statement, (SQLUSMALLINT) (i + 1), SQL_PARAM_INPUT, cType, sqlType, size, digits,
+                                (SQLPOINTER) data, (SQLLEN) cell, ind);
+    }
+    switch (status) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      return false;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcBindParamValues
+ * Binds each value of a javascript array as an input parameter of a statement, in order starting at 1.
+ * Values are bound according to their javascript type, as by ndbcBindParamArrays for a single row:
+ *   null or undefined - A null VARCHAR.
+ *   boolean - BIT.
+ *   number - INTEGER for 32 bit integers, BIGINT for other integers that a double holds exactly, or DOUBLE.
+ *   string - VARCHAR, or LONGVARCHAR past 8000 bytes, encoded as UTF-8.
+ *   Buffer - VARBINARY, or LONGVARBINARY past 8000 bytes.
+ *   Date - TIMESTAMP to the millisecond, in UTC.
+ * Returns false and sets retVal to the error string if params is not an array, a value has any other type, or
+ * binding fails.
+ */
+bool ndbcBindParamValues(SQLHANDLE statement, Local<Value> params, Local<Value>& retVal) {
+  Local<Array> rows = Array::New(1);
+
+  rows->Set(0, params);
+  return ndbcBindParamArrays(statement, rows, 0, 1, false, retVal);
+}
+
+/* ndbc internal type ndbcBuffer
+ * A growable output buffer.
+ * data - The buffer contents.
+ * len - The number of bytes in use.
+ * size - The number of bytes allocated.
+ */
+typedef struct {
+  char* data;
+  size_t len;
+  size_t size;
+} ndbcBuffer;
+
+/* ndbc internal function ndbcBufferReserve
+ * Makes sure buf has room for at least <more> bytes past its current length, doubling the allocation as needed.
+ * Returns false if memory could not be allocated or the length would not fit in a size_t.
+ */
+bool ndbcBufferReserve(ndbcBuffer* buf, size_t more) {
+  size_t size = (buf->size > 0) ? buf->size : 256;
+  size_t need = buf->len;
+  char* data;
+
+  if (!ndbcAddSize(&need, more)) {
+    return false;
+  }
+  if (need <= buf->size) {
+    return true;
+  }
+  while (size < need) {
+    // Stop doubling once another doubling would overflow, and allocate just what is needed.
+    size = (size <= ((size_t) -1) / 2) ? size * 2 : need;
+  }
+  data = (char*) realloc(buf->data, size);
+  if (data == NULL) {
+    return false;
+  }
+  buf->data = data;
+  buf->size = size;
+  return true;
+}
+
+/* ndbc internal function ndbcBufferAppend
+ * Copies len bytes of data to the end of buf.
+ * Returns false if memory could not be allocated.
+ */
+bool ndbcBufferAppend(ndbcBuffer* buf, const char* data, size_t len) {
+  if (!ndbcBufferReserve(buf, len)) {
+    return false;
+  }
+  memcpy(buf->data + buf->len, data, len);
+  buf->len += len;
+  return true;
+}
+
+/* ndbc internal type ndbcDictionary
+ * Collects the distinct values of a dictionary-encoded column.
+ * Values are compared in their serialized form, so each distinct value is stored and output exactly once.
+ * values - The serialized distinct values, comma separated, in code order.
+ * count - The number of distinct values.
+ * offset - The position of each distinct value within values.
+ * length - The serialized length of each distinct value.
+ * slots - Open addressing hash table holding (code + 1) for each distinct value.  0 marks an empty slot.
+ * slotCount - The number of hash table slots.  Always a power of 2.
+ */
+typedef struct {
+  ndbcBuffer values;
+  SQLUINTEGER count;
+  size_t* offset;
+  size_t* length;
+  SQLUINTEGER* slots;
+  SQLUINTEGER slotCount;
+} ndbcDictionary;
+
+/* ndbc internal function ndbcDictionaryCode
+ * Looks up the serialized value written at values.data + start with length len.
+ * Known values are discarded and their existing code returned.
+ * New values are kept in the dictionary and assigned the next code.
+ * Returns the value's code, or (SQLUINTEGER) -1 if memory could not be allocated.
+ */
+SQLUINTEGER ndbcDictionaryCode(ndbcDictionary* dict, size_t start, size_t len) {
+  char* value = dict->values.data + start;
+  SQLUINTEGER slot;
+  SQLUINTEGER code;
+  SQLUINTEGER i;
+
+  if (dict->slots != NULL) {
+    for (slot = ndbcHash(value, len) & (dict->slotCount - 1); dict->slots[slot] != 0; slot = (slot + 1) & (dict->slotCount - 1)) {
+      code = dict->slots[slot] - 1;
+      if (dict->length[code] == len && memcmp(dict->values.data + dict->offset[code], value, len) == 0) {
+        return code;
+      }
+    }
+  }
+
+  // Grow the code lists and rehash when the table is half full.
+  if ((dict->count + 1) * 2 > dict->slotCount) {
+    SQLUINTEGER slotCount = (dict->slotCount > 0) ? dict->slotCount * 2 : 64;
+    SQLUINTEGER* slots = (SQLUINTEGER*) calloc(slotCount, sizeof(SQLUINTEGER));
+    size_t* offset = (size_t*) realloc(dict->offset, sizeof(size_t) * (slotCount / 2));
+    size_t* length;
+    if (offset != NULL) {
+      dict->offset = offset;
+    }
+    length = (size_t*) realloc(dict->length, sizeof(size_t) * (slotCount / 2));
+    if (length != NULL) {
+      dict->length = length;
+    }
+    if (slots == NULL || offset == NULL || length == NULL) {
+      free(slots);
+      return (SQLUINTEGER) -1;
+    }
+    for (i = 0; i < dict->count; i++) {
+      slot = ndbcHash(dict->values.data + dict->offset[i], dict->length[i]) & (slotCount - 1);
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & (slotCount - 1);
+      }
+      slots[slot] = i + 1;
+    }
+    free(dict->slots);
+    dict->slots = slots;
+    dict->slotCount = slotCount;
+  }
+
+  // Keep the new value and assign it the next code.
+  code = dict->count;
+  dict->offset[code] = start;
+  dict->length[code] = len;
+  dict->count++;
+  dict->values.len = start + len;
+  for (slot = ndbcHash(value, len) & (dict->slotCount - 1); dict->slots[slot] != 0; slot = (slot + 1) & (dict->slotCount - 1)) {
+  }
+  dict->slots[slot] = code + 1;
+  return code;
+}
+
+/* ndbc internal function ndbcDescribeResult
+ * Returns the metadata of a statement's current result set through meta.
+ * The metadata is collected with SQLDescribeCol and SQLColAttribute on first use, then cached on the statement
+ * until it moves to another result set, so repeated describes cost no further driver calls.
+ * The metadata belongs to the statement's state and must not be freed by the caller.
+ * Returns the failing SQLRETURN value if the result set could not be described, or SQL_SUCCESS.
+ */
+SQLRETURN ndbcDescribeResult(SQLHANDLE statement, ndbcResultMeta** meta) {
+  ndbcStatementState* state = ndbcGetStatementState(statement, true);
+  ndbcResultMeta* result;
+  ndbcColumnMeta* column;
+  SQLSMALLINT columns;
+  SQLSMALLINT typeNameLen;
+  SQLLEN attr;
+  SQLCHAR name[256];
+  SQLRETURN rc;
+  SQLSMALLINT j;
+
+  if (state == NULL) {
+    return SQL_ERROR;
+  }
+  if (state->meta != NULL) {
+    *meta = state->meta;
+    return SQL_SUCCESS;
+  }
+  rc = SQLNumResultCols(statement, &columns);
+  if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) {
+    return rc;
+  }
+  // Build the metadata in the statement's scratch arena, reusing the memory of earlier result sets.
+  ndbcArenaReset(&state->scratch);
+  if (columns < 0) {
+    columns = 0;
+  }
+  result = (ndbcResultMeta*) ndbcArenaAlloc(&state->scratch, sizeof(ndbcResultMeta) + (columns * sizeof(ndbcColumnMeta)));
+  if (result == NULL) {
+    return SQL_ERROR;
+  }
+  result->columns = 0;
+  result->column = (ndbcColumnMeta*) (result + 1);
+  memset(result->column, 0, columns * sizeof(ndbcColumnMeta));
+  for (j = 0; j < columns; j++) {
+    column = &result->column[j];
+    result->columns = j + 1;
+    rc = SQLDescribeCol(statement, j + 1, name, sizeof(name), &column->nameLen, &column->type, &column->size,
+                        &column->digits, &column->nullable);
+    if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) {
+      return rc;
+    }
+    if (column->nameLen < 0) {
+      column->nameLen = 0;
+    }
+    column->name = ndbcArenaAlloc(&state->scratch, column->nameLen + 1);
+    if (column->name == NULL) {
+      return SQL_ERROR;
+    }
+    if (column->nameLen < (SQLSMALLINT) sizeof(name)) {
+      memcpy(column->name, name, column->nameLen + 1);
+    } else {
+      // The name did not fit the buffer, so ask again with room for all of it.
+      rc = SQLDescribeCol(statement, j + 1, (SQLCHAR*) column->name, column->nameLen + 1, NULL, NULL, NULL, NULL, NULL);
+      if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) {
+        return rc;
+      }
+    }
+    column->name[column->nameLen] = 0;
+    // Descriptor fields beyond SQLDescribeCol are informational, so a driver that lacks one leaves it empty.
+    rc = SQLColAttribute(statement, j + 1, SQL_DESC_TYPE_NAME, name, sizeof(name), &typeNameLen, NULL);
+    if ((rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO) || typeNameLen < 0) {
+      typeNameLen = 0;
+    } else if (typeNameLen >= (SQLSMALLINT) sizeof(name)) {
+      typeNameLen = sizeof(name) - 1;
+    }
+    column->typeName = ndbcArenaAlloc(&state->scratch, typeNameLen + 1);
+    if (column->typeName == NULL) {
+      return SQL_ERROR;
+    }
+    memcpy(column->typeName, name, typeNameLen);
+    column->typeName[typeNameLen] = 0;
+    if (SQLColAttribute(statement, j + 1, SQL_DESC_PRECISION, NULL, 0, NULL, &column->precision) == SQL_ERROR) {
+      column->precision = 0;
+    }
+    if (SQLColAttribute(statement, j + 1, SQL_DESC_SCALE, NULL, 0, NULL, &column->scale) == SQL_ERROR) {
+      column->scale = 0;
+    }
+    if (SQLColAttribute(statement, j + 1, SQL_DESC_DISPLAY_SIZE, NULL, 0, NULL, &column->displaySize) == SQL_ERROR) {
+      column->displaySize = 0;
+    }
+    attr = SQL_FALSE;
+    SQLColAttribute(statement, j + 1, SQL_DESC_UNSIGNED, NULL, 0, NULL, &attr);
+    column->isUnsigned = (attr == SQL_TRUE);
+  }
+  result->columns = columns;
+  state->meta = result;
+  *meta = result;
+  return SQL_SUCCESS;
+}
+
+/* ndbc internal function ndbcSQLType
+ * Returns the string representation of an SQL data type constant, or the constant's value if it has none.
+ */
+Local<Value> ndbcSQLType(SQLSMALLINT type) {
+  switch (type) {
+  case SQL_BIGINT:
+    return ndbcSQL_BIGINT;
+  case SQL_BINARY:
+    return ndbcSQL_BINARY;
+  case SQL_BIT:
+    return ndbcSQL_BIT;
+  case SQL_CHAR:
+    return ndbcSQL_CHAR;
+  case SQL_DECIMAL:
+    return ndbcSQL_DECIMAL;
+  case SQL_DOUBLE:
+    return ndbcSQL_DOUBLE;
+  case SQL_FLOAT:
+    return ndbcSQL_FLOAT;
+  case SQL_GUID:
+    return ndbcSQL_GUID;
+  case SQL_INTEGER:
+    return ndbcSQL_INTEGER;
+  case SQL_LONGVARBINARY:
+    return ndbcSQL_LONGVARBINARY;
+  case SQL_LONGVARCHAR:
+    return ndbcSQL_LONGVARCHAR;
+  case SQL_NUMERIC:
+    return ndbcSQL_NUMERIC;
+  case SQL_REAL:
+    return ndbcSQL_REAL;
+  case SQL_SMALLINT:
+    return ndbcSQL_SMALLINT;
+  case SQL_TINYINT:
+    return ndbcSQL_TINYINT;
+  case SQL_TYPE_DATE:
+    return ndbcSQL_TYPE_DATE;
+  case SQL_TYPE_TIME:
+    return ndbcSQL_TYPE_TIME;
+  case SQL_TYPE_TIMESTAMP:
+    return ndbcSQL_TYPE_TIMESTAMP;
+  case SQL_UNKNOWN_TYPE:
+    return ndbcSQL_UNKNOWN_TYPE;
+  case SQL_VARBINARY:
+    return ndbcSQL_VARBINARY;
+  case SQL_VARCHAR:
+    return ndbcSQL_VARCHAR;
+  case SQL_WCHAR:
+    return ndbcSQL_WCHAR;
+  case SQL_WLONGVARCHAR:
+    return ndbcSQL_WLONGVARCHAR;
+  case SQL_WVARCHAR:
+    return ndbcSQL_WVARCHAR;
+  default:
+    return Integer::New(type);
+  }
+}
+
+/* ndbc custom function ndbcJsonMetadata
+ * ndbcJsonMetadata(statement)
+ * statement - An statement handle that has an available result set.
+ *
+ * Returns an array with an object describing each column of the result set:
+ *   name: The column name.
+ *   type: The SQL data type, as a string such as 'SQL_VARCHAR' where there is one, or as a number.
+ *   typeName: The data source's name for the data type.
+ *   size: The column size.
+ *   digits: The column's decimal digits.
+ *   precision: The precision of numeric columns.
+ *   scale: The scale of numeric columns.
+ *   displaySize: The maximum number of characters required to display the column's data.
+ *   nullable: true or false, or null if unknown.
+ *   unsigned: true if the data type is unsigned (or not numeric).
+ * The metadata is collected once per result set and cached on the statement, where JsonDescribe and
+ * JsonHeader also use it, so describing a result set more than once costs no further driver calls.
+ * Returns SQL_ERROR if there are any problems.
+ */
+Handle<Value> ndbcJsonMetadata(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcResultMeta* meta;
+  ndbcColumnMeta* column;
+  Local<Array> columns;
+  Local<Object> columnObject;
+  SQLSMALLINT j;
+
+  switch (ndbcDescribeResult((SQLHANDLE) External::Unwrap(args[0]), &meta)) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
+  default:
+    columns = Array::New(meta->columns);
+    for (j = 0; j < meta->columns; j++) {
+      column = &meta->column[j];
+      columnObject = Object::New();
+      columnObject->Set(String::NewSymbol("name"), String::New(column->name, column->nameLen));
+      columnObject->Set(String::NewSymbol("type"), ndbcSQLType(column->type));
+      columnObject->Set(String::NewSymbol("typeName"), String::New(column->typeName));
+      columnObject->Set(String::NewSymbol("size"), Number::New((double) column->size));
+      columnObject->Set(String::NewSymbol("digits"), Integer::New(column->digits));
+      columnObject->Set(String::NewSymbol("precision"), Number::New((double) column->precision));
+      columnObject->Set(String::NewSymbol("scale"), Number::New((double) column->scale));
+      columnObject->Set(String::NewSymbol("displaySize"), Number::New((double) column->displaySize));
+      if (column->nullable == SQL_NULLABLE) {
+        columnObject->Set(String::NewSymbol("nullable"), True());
+      } else if (column->nullable == SQL_NO_NULLS) {
+        columnObject->Set(String::NewSymbol("nullable"), False());
+      } else {
+        columnObject->Set(String::NewSymbol("nullable"), Null());
+      }
+      columnObject->Set(String::NewSymbol("unsigned"), Boolean::New(column->isUnsigned));
+      columns->Set(j, columnObject);
+    }
+    retVal = columns;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal function ndbcDescribeRows
+ * Builds a row descriptor for a statement's current result set, with options as described for ndbcJsonDescribe.
+ * options may be empty or undefined for the defaults.
+ * Returns true and sets retVal to the descriptor object if it succeeds.
+ * Returns false and sets retVal to the error string otherwise.
+ */
+bool ndbcDescribeRows(SQLHANDLE statement, Handle<Value> options, Local<Value>& retVal) {
+  ndbcRowDesc* desc = NULL;
+  ndbcResultMeta* meta;
+  SQLUSMALLINT i;
+  size_t recLen = 2;
+  size_t fieldLen;
+  bool ok = true;
+  SQLSMALLINT dataType;
+  SQLULEN dataLen;
+  char decimal = 'n';
+  char datetime = 'i';
+  char guid = 'g';
+  Local<Value> option;
+  Local<Array> projection;
+  SQLUINTEGER columns;
+  SQLUINTEGER source;
+  ndbcColumnMeta* column;
+
+  // Read the options, if any
+  if (!options.IsEmpty() && !options->IsUndefined()) {
+    if (!options->IsObject()) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    } else {
+      option = options->ToObject()->Get(ndbcDECIMAL);
+      if (option->IsUndefined() || option->ToString() == ndbcTEXT) {
+        decimal = 'n';
+      } else if (option->ToString() == ndbcNUMBER) {
+        decimal = 'd';
+      } else if (option->ToString() == ndbcSTRING) {
+        decimal = 's';
+      } else if (option->ToString() == ndbcSCALED) {
+        decimal = 'i';
+      } else if (option->ToString() == ndbcPAIR) {
+        decimal = 'p';
+      } else {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+      }
+      option = options->ToObject()->Get(ndbcDATETIME);
+      if (option->IsUndefined() || option->ToString() == ndbcISO) {
+        datetime = 'i';
+      } else if (option->ToString() == ndbcEPOCH) {
+        datetime = 'e';
+      } else if (option->ToString() == ndbcTEXT) {
+        datetime = 'q';
+      } else {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+      }
+      option = options->ToObject()->Get(ndbcGUID);
+      if (option->IsUndefined() || option->ToString() == ndbcSTRING) {
+        guid = 'g';
+      } else if (option->ToString() == ndbcTEXT) {
+        guid = 'q';
+      } else {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+      }
+      option = options->ToObject()->Get(ndbcCOLUMNS);
+      if (option->IsArray()) {
+        projection = Local<Array>::Cast(option);
+      } else if (!option->IsUndefined()) {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+      }
+    }
+  }
+
+  if (ok) {
+    // Collect the result set's column metadata, or reuse the metadata cached on the statement
+    switch (ndbcDescribeResult(statement, &meta)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      break;
+    default:
+      // Check that any projected columns are in the result set
+      columns = projection.IsEmpty() ? meta->columns : projection->Length();
+      for (i = 0; !projection.IsEmpty() && i < columns && ok; i++) {
+        source = projection->Get(i)->Uint32Value();
+        if (columns >= 32768 || source < 1 || source > (SQLUINTEGER) meta->columns) {
+          retVal = ndbcINVALID_ARGUMENT;
+          ok = false;
+        }
+      }
+      // Allocate the row description for the column count
+      if (ok) {
+        desc = ndbcNewRowDesc((SQLSMALLINT) columns);
+        if (desc == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+        }
+      }
+      for (i = 1; i <= columns && ok; i++) {
+        // Bind the output column to its projected result set column, or to the one in the same position
+        if (!projection.IsEmpty()) {
+          desc->column[i - 1] = (SQLUSMALLINT) projection->Get(i - 1)->Uint32Value();
+        }
+        column = &meta->column[desc->column[i - 1] - 1];
+        // Record the column description and increment the total record length
+        dataType = column->type;
+        dataLen = column->size;
+        fieldLen = 0;
+        // Columns too large to buffer can not be bound, and the room left keeps the length arithmetic below exact.
+        if (dataLen >= ndbcMaxLength / 2) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        // Minimum output length is 5 for NULL data represented as 'null' plus a comma.
+        switch (dataType) {
+        case SQL_DECIMAL:
+        case SQL_NUMERIC:
+          if (decimal != 'n' && dataLen >= 1 && dataLen <= 38 && column->digits >= 0
+              && column->digits <= (SQLSMALLINT) dataLen) {
+            // Bind as a numeric structure at the column's precision and scale.
+            desc->precision[i - 1] = (SQLSMALLINT) dataLen;
+            desc->scale[i - 1] = column->digits;
+            dataLen = sizeof(SQL_NUMERIC_STRUCT);
+            // At most 39 digits, a sign, a decimal point, quotes and a comma.
+            fieldLen = 44;
+            desc->serialize[i - 1] = decimal;
+            break;
+          }
+          // Add in 2 for a decimal point and a sign.
+          dataLen += 2;
+          // Add 1 for a comma, and make sure the resulting length is at least 5.
+          fieldLen = ((dataLen > 4) ? dataLen : 4) + 1;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_BIT:
+          dataLen = 1;
+          // Minimum output length is 5.
+          fieldLen = 5;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_TINYINT:
+          dataLen = 4;
+          // Add 1 for a comma.
+          fieldLen = 5;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_SMALLINT:
+          dataLen = 6;
+          fieldLen = 7;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_INTEGER:
+          dataLen = 11;
+          fieldLen = 12;
+          desc->serialize[i - 1] = 'n';
+          break;
         case SQL_BIGINT:
-          *dataLen = 20;
-          recLen += 21;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
+          dataLen = 20;
+          fieldLen = 21;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_REAL:
+          dataLen = 14;
+          fieldLen = 15;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_FLOAT:
+        case SQL_DOUBLE:
+          dataLen = 24;
+          fieldLen = 25;
+          desc->serialize[i - 1] = 'n';
+          break;
+        case SQL_CHAR:
+        case SQL_VARCHAR:
+        case SQL_LONGVARCHAR:
+        case SQL_WCHAR:
+        case SQL_WVARCHAR:
+        case SQL_WLONGVARCHAR:
+          // Double length for escape sequences, add 3 for quotes and a comma.
+          fieldLen = (dataLen * 2) + 3;
+          desc->serialize[i - 1] = 'q';
+          break;
+        case SQL_TYPE_DATE:
+        case SQL_TYPE_TIME:
+        case SQL_TYPE_TIMESTAMP:
+          if (datetime == 'e') {
+            // Bind as a structure and output milliseconds: at most 20 characters and a comma.
+            desc->serialize[i - 1] = (dataType == SQL_TYPE_TIME) ? 'M' : 'E';
+            dataLen = ndbcBindSize(desc->serialize[i - 1]);
+            fieldLen = 21;
+            break;
+          } else if (datetime == 'i') {
+            // Bind as a structure and output ISO-8601 text, adding 3 for quotes and a comma.
+            if (dataType == SQL_TYPE_DATE) {
+              desc->serialize[i - 1] = 'D';
+              fieldLen = 15;
+            } else if (dataType == SQL_TYPE_TIME) {
+              desc->serialize[i - 1] = 'T';
+              fieldLen = 11;
+            } else {
+              desc->serialize[i - 1] = 'S';
+              desc->scale[i - 1] = (column->digits < 0) ? 0 : (column->digits > 9) ? 9 : column->digits;
+              fieldLen = 34;
+            }
+            dataLen = ndbcBindSize(desc->serialize[i - 1]);
+            break;
+          }
+          // Otherwise read it as text, like the types below.
+          // fall through
+        case SQL_GUID:
+          if (dataType == SQL_GUID && guid == 'g') {
+            // Bind as a structure and output the 36 character canonical form, adding 3 for quotes and a comma.
+            desc->serialize[i - 1] = 'g';
+            dataLen = ndbcBindSize('g');
+            fieldLen = 39;
+            break;
+          }
+          // fall through
+        case SQL_INTERVAL_MONTH:
+        case SQL_INTERVAL_YEAR:
+        case SQL_INTERVAL_YEAR_TO_MONTH:
+        case SQL_INTERVAL_DAY:
+        case SQL_INTERVAL_HOUR:
+        case SQL_INTERVAL_MINUTE:
+        case SQL_INTERVAL_SECOND:
+        case SQL_INTERVAL_DAY_TO_HOUR:
+        case SQL_INTERVAL_DAY_TO_MINUTE:
+        case SQL_INTERVAL_DAY_TO_SECOND:
+        case SQL_INTERVAL_HOUR_TO_MINUTE:
+        case SQL_INTERVAL_HOUR_TO_SECOND:
+        case SQL_INTERVAL_MINUTE_TO_SECOND:
+          // Add 1 to data length to fix date length bug
+          dataLen += 1;
+          // Add 3 for quotes and a comma
+          fieldLen = dataLen + 3;
+          desc->serialize[i - 1] = 'q';
+          break;
+        case SQL_BINARY:
+        case SQL_VARBINARY:
+        case SQL_LONGVARBINARY:
+        case SQL_UNKNOWN_TYPE:
+        default:
+          // Multiply length by 4/3 for base64 encoding, add 3 for quotes and a comma.
+          fieldLen = ((dataLen / 3) * 4) + 3;
+          // Remaindered source data will add another 4 bytes to the base64 encoded length.
+          if (dataLen % 3 != 0) {
+            fieldLen += 4;
+          }
+          desc->serialize[i - 1] = 'q';
+        }
+        if (!ndbcAddSize(&recLen, fieldLen) || recLen > ndbcMaxLength) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        desc->type[i - 1] = dataType;
+        desc->colLen[i - 1] = dataLen;
+      }
+      if (ok && !ndbcUniqueColumns(desc)) {
+        retVal = ndbcINVALID_ARGUMENT;
+        ok = false;
+      }
+      if (ok) {
+        // Record the total record length and lay out the bound row
+        desc->recLen = recLen;
+        if (!ndbcLayoutRowDesc(desc)) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+        }
+      }
+      if (ok) {
+        // Wrap the description for output
+        ok = ndbcWrapRowDesc(desc, retVal);
+      }
+      if (!ok) {
+        free(desc);
+      }
+    }
+  }
+  return ok && desc != NULL;
+}
+
+/* ndbc custom function ndbcJsonDescribe
+ * ndbcJsonDescribe(statement, [options])
+ * statement - An statement handle that has an available result set.
+ * options - An object that may contain the following properties:
+ *   decimal: How to output SQL_DECIMAL and SQL_NUMERIC columns.
+ *     'text': As the driver's text form, unquoted (default).  Json parsers read these as doubles, which may round them.
+ *     'number': Bound as SQL_NUMERIC_STRUCT and formatted exactly, unquoted.
+ *     'string': Bound as SQL_NUMERIC_STRUCT and formatted exactly, quoted.
+ *     'scaled': The value multiplied by 10 to the power of its scale, as a quoted integer.
+ *     'pair': The scaled value as an array of its signed high and unsigned low 32 bits, so it can be rebuilt exactly
+ *             as hi * 4294967296 + lo while it is within 2^53, or as a 64 bit integer.  Values beyond 64 bits are
+ *             output as for 'scaled'.
+ *   Columns whose precision exceeds 38 or whose scale is negative are always output as 'text'.
+ *   datetime: How to output SQL_TYPE_DATE, SQL_TYPE_TIME and SQL_TYPE_TIMESTAMP columns.
+ *     'iso': Bound as ODBC date / time structures and formatted as quoted ISO-8601 text, eg. "2012-07-28T13:45:00.250"
+ *            (default).  Timestamps keep as many fractional second digits as the column has.
+ *     'epoch': Bound as structures and output as unquoted milliseconds since 1970-01-01T00:00:00 (times since midnight).
+ *              The values have no time zone, so they are treated as UTC.
+ *     'text': As the driver's text form, quoted.
+ *   columns: An array of the distinct result set column numbers (starting at 1) to output, in output order.
+ *            Columns not listed are never bound, fetched or serialized.  Defaults to every column.
+ *   guid: How to output SQL_GUID columns.
+ *     'string': Bound as SQLGUID and formatted as a quoted lower case 8-4-4-4-12 string (default).
+ *     'text': As the driver's text form, quoted.
+ * 
+ * Returns a descriptor object describing how to bind result set data when returning rows via ndbcJsonData.
+ * The descriptor holds the description in native form, so fetch functions use it without re-parsing.
+ * Do NOT attempt to modify it in javascript.
+ * Designed to run synchronously.
+ * Returns SQL_ERROR if there are any problems, or INVALID_ARGUMENT if the options are not recognized.
+ * The descriptor's rowDesc property holds the same description as a string, which the fetch functions also
+ * accept in place of the descriptor (eg. after passing it to another process).
+ * The string contains the following header information:
+ *   columns: The character 'c' followed by a number representing the number of output columns.
+ *   length: The character 'l' followed by the number of bytes required to represent a single row of data in Json format.
+ *           This includes extra space for escape sequences, literal delimiters, and enclosing braces.
+ * The returned string contains text for each column in the following format:
+ *   serialize: A character representing how to serialize the column's data.
+ *     q: Quoted, the data will be enclosed by double quotes and formatted into a string literal.
+ *        Control characters 0x00-0x1f are replaced by spaces.
+ *        Special character escape sequences \ to \\ and " to \" are applied.
+ *     b: Quoted, the data will be enclosed by double quotes and encoded in base64 format.
+ *     n: Not quoted, the data will not be enclosed by anything and will not be formatted.
+ *     d, s, i, p: Exact decimals, output as for the 'number', 'string', 'scaled' and 'pair' decimal options.
+ *     D, T, S: Dates, times and timestamps, output as quoted ISO-8601 text.
+ *     E, M: Dates or timestamps, and times, output as milliseconds as for the 'epoch' datetime option.
+ *     g: GUIDs, output as quoted strings in the canonical 8-4-4-4-12 form.
+ *   length: A number representing the maximum byte length of this field's output.
+ *           This does not include extra space for escape sequences or null termination.
+ *           Exact decimals give their precision and scale instead, separated by '.', eg. "s12.2".
+ *           Dates and times give the number of fractional second digits output instead, eg. "S3", and GUIDs give 0.
+ */
+Handle<Value> ndbcJsonDescribe(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcDescribeRows((SQLHANDLE) External::Unwrap(args[0]), (args.Length() > 1) ? args[1] : Local<Value>(), retVal);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonHeader
+ * ndbcJsonHeader(statement, [rowdesc])
+ * statement - An statement handle that has an available result set.
+ * rowdesc - A row descriptor produced by ndbcJsonDescribe, or its rowDesc string.  If given, the header names the
+ *           columns the descriptor outputs, in its order.  Defaults to every column of the result set.
+ *
+ * Returns a Json-formatted array with column names for the result set.
+ * Column names are escaped as Json string literals and may be of any length.
+ * Returns a leading [ character to begin the array of records.
+ */
+Handle<Value> ndbcJsonHeader(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcResultMeta* meta;
+  ndbcRowDesc* desc = NULL;
+  ndbcRowDesc* parsed = NULL;
+  ndbcColumnMeta* column;
+  SQLSMALLINT columns;
+  SQLSMALLINT i;
+  SQLUINTEGER k;
+  char headerBuf[1024];
+  char* header = headerBuf;
+
+  // Collect the result set's column metadata, or reuse the metadata cached on the statement
+  switch (ndbcDescribeResult((SQLHANDLE) External::Unwrap(args[0]), &meta)) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    break;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    break;
+  case SQL_STILL_EXECUTING:
+    retVal = ndbcSQL_STILL_EXECUTING;
+    break;
+  default:
+    // Name the descriptor's columns if one was given, checking that they are in the result set
+    columns = meta->columns;
+    if (args.Length() > 1 && !args[1]->IsUndefined()) {
+      desc = ndbcResolveRowDesc(args[1], &parsed);
+      if (desc == NULL) {
+        retVal = ndbcINVALID_ARGUMENT;
+        break;
+      }
+      columns = desc->columns;
+      for (i = 0; i < columns; i++) {
+        if (desc->column[i] > meta->columns) {
+          desc = NULL;
+          break;
+        }
+      }
+      if (desc == NULL) {
+        retVal = ndbcINVALID_ARGUMENT;
+        break;
+      }
+    }
+    // Size the header exactly: the opening braces, each escaped name and separating comma, and the closing brace
+    k = 3;
+    for (i = 0; i < columns; i++) {
+      column = &meta->column[(desc != NULL) ? desc->column[i] - 1 : i];
+      k += ndbcWriteJsonString(NULL, column->name, column->nameLen) + 1;
+    }
+    if (k > sizeof(headerBuf)) {
+      header = (char*) malloc(k);
+      if (header == NULL) {
+        retVal = ndbcINTERNAL_ERROR;
+        break;
+      }
+    }
+    // Write the header array to the output
+    k = 0;
+    header[k] = '[';
+    k++;
+    header[k] = '[';
+    k++;
+    for (i = 0; i < columns; i++) {
+      if (i > 0) {
+        header[k] = ',';
+        k++;
+      }
+      column = &meta->column[(desc != NULL) ? desc->column[i] - 1 : i];
+      k += ndbcWriteJsonString(header + k, column->name, column->nameLen);
+    }
+    // Add the closing brace
+    header[k] = ']';
+    k++;
+    retVal = String::New(header, k);
+    if (header != headerBuf) {
+      free(header);
+    }
+  }
+  free(parsed);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonData
+ * ndbcJsonData(statement, rowdesc, [rows], [maxBytes])
+ * statement - An statement handle that has an available result set.
+ * rowdesc - The row descriptor produced by ndbcJsonDescribe, or its rowDesc string.
+ * rows - The number of rows to output.  Defaults to 1.
+ *        0 outputs every remaining row of the result set in a single call.
+ * maxBytes - The maximum length of the output.  Defaults to 0, for no maximum other than the longest string V8
+ *            can create.
+ *            A fetched row that would take the output past maxBytes is held back and returned first by the next
+ *            call on the statement.  A single row longer than maxBytes is still returned on its own.
+ *
+ * Returns a Json-formatted array with column data for the next <length> rows in the result set.
+ * Output is gathered in memory sized to the rows actually fetched, not to the worst-case row length.
+ * Returns truncated results if the number of remaining rows is less than the number of requested rows.
+ * Returns a leading comma before each row of data to continue the array of records (assumes this will be
+ * concatenated with the results of ndbcJsonHeader).
+ * Returns a trailing ']' if there is no more result set data, to close the array of records.
+ * Returns SQL_NO_DATA if the end of the result set has already been reached.
+ */
+Handle<Value> ndbcJsonData(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  ndbcRowBuffer rowBuf;
+  SQLUINTEGER i;
+  SQLUINTEGER rows;
+  size_t maxBytes = ndbcMaxString;
+  size_t k;
+  ndbcArena arena = { NULL, NULL, 0 };
+  char* recData;
+  bool ok = true;
+  bool data = true;
+
+  if (args.Length() >= 3) {
+    rows = (SQLUINTEGER) args[2]->Uint32Value();
+  } else {
+    rows = 1;
+  }
+  if (args.Length() >= 4 && args[3]->IntegerValue() > 0 && (size_t) args[3]->IntegerValue() < ndbcMaxString) {
+    maxBytes = (size_t) args[3]->IntegerValue();
+  }
+
+  // Bind the result set columns as laid out by the row description.
+  ok = ndbcBindRowDesc((SQLHANDLE) External::Unwrap(args[0]), args[1], &rowBuf, retVal);
+
+  if (ok) {
+    // Fetch the specified number of rows, or every remaining row if rows is 0.
+    for (i = 0; ok && data && (rows == 0 || i < rows); i++) {
+      switch (ndbcFetch((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        ok = false;
+        break;
+      case SQL_STILL_EXECUTING:
+        retVal = ndbcSQL_STILL_EXECUTING;
+        ok = false;
+        break;
+      case SQL_NO_DATA:
+        // Return SQL_NO_DATA if no data has been read so far.
+        if (arena.len > 0) {
+          data = false;
+        } else {
+          retVal = ndbcSQL_NO_DATA;
+          ok = false;
+        }
+        break;
+      default:
+        // Reserve room for a full row in the output arena.
+        recData = ndbcArenaReserve(&arena, rowBuf.recLen);
+        if (recData == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        k = ndbcWriteRow(recData, &rowBuf);
+        if (arena.len > 0 && arena.len + k > maxBytes) {
+          // Hold the row back for the next call rather than exceed maxBytes.
+          if (!ndbcHoldRow((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+            retVal = ndbcINTERNAL_ERROR;
+            ok = false;
+          }
+          data = false;
+          break;
+        }
+        ndbcArenaCommit(&arena, k);
+      }
+    }
+  }
+  
+  if (ok) {
+    // Copy the formatted data to the output.
+    ndbcArenaToString(&arena, retVal);
+  }
+  // Free allocated memory resources.
+  ndbcFreeRowBuffer(&rowBuf);
+  ndbcFreeArena(&arena);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonDataBudget
+ * ndbcJsonDataBudget(statement, rowdesc, milliseconds, [bytes])
+ * statement - An statement handle that has an available result set.
+ * rowdesc - The row descriptor produced by ndbcJsonDescribe, or its rowDesc string.
+ * milliseconds - The target time to spend fetching and formatting rows in this call.  0 for no time limit.
+ * bytes - The target output length for this call.  Defaults to 0, for no length limit.
+ *
+ * Returns the next rows of the result set in the same format as ndbcJsonData, choosing the number of rows
+ * so the call stays within the given budgets.
+ * Keeps a moving average of the time and output length of each row for the statement, and stops before
+ * the next row is expected to exceed either budget, so the row count adapts as the cost of rows changes.
+ * Always returns at least one row if one is available.
+ * Returns SQL_NO_DATA if the end of the result set has already been reached.
+ */
+Handle<Value> ndbcJsonDataBudget(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  ndbcRowBuffer rowBuf;
+  ndbcStatementState* state;
+  ndbcArena arena = { NULL, NULL, 0 };
+  size_t k;
+  double timeBudget = args[2]->NumberValue() * 1000000;
+  double byteBudget = 0;
+  uint64_t start;
+  uint64_t now;
+  uint64_t last;
+  char* recData;
+  bool ok = true;
+  bool data = true;
+
+  rowBuf.statement = NULL;
+  rowBuf.parsed = NULL;
+  if (args.Length() > 3) {
+    byteBudget = args[3]->NumberValue();
+  }
+  if (!(timeBudget >= 0) || !(byteBudget >= 0)) {
+    retVal = ndbcINVALID_ARGUMENT;
+    ok = false;
+  }
+
+  // Bind the result set columns as laid out by the row description.
+  if (ok) {
+    ok = ndbcBindRowDesc((SQLHANDLE) External::Unwrap(args[0]), args[1], &rowBuf, retVal);
+  }
+
+  if (ok) {
+    state = ndbcGetStatementState((SQLHANDLE) External::Unwrap(args[0]), true);
+    if (state == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+
+  if (ok) {
+    start = uv_hrtime();
+    last = start;
+    while (ok && data) {
+      // Stop before the next row is expected to overrun a budget, once at least one row has been output.
+      if (arena.len > 0) {
+        if (timeBudget > 0 && (double) (last - start) + state->rowTime > timeBudget) {
+          break;
+        }
+        if (byteBudget > 0 && arena.len + state->rowBytes > byteBudget) {
+          break;
+        }
+      }
+      switch (ndbcFetch((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        ok = false;
+        break;
+      case SQL_STILL_EXECUTING:
+        retVal = ndbcSQL_STILL_EXECUTING;
+        ok = false;
+        break;
+      case SQL_NO_DATA:
+        // Return SQL_NO_DATA if no data has been read so far.
+        if (arena.len > 0) {
+          data = false;
+        } else {
+          retVal = ndbcSQL_NO_DATA;
+          ok = false;
+        }
+        break;
+      default:
+        // Reserve room for a full row in the output arena.
+        recData = ndbcArenaReserve(&arena, rowBuf.recLen);
+        if (recData == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        k = ndbcWriteRow(recData, &rowBuf);
+        if (arena.len > 0 && arena.len + k > ndbcMaxString) {
+          // Hold the row back for the next call rather than exceed the longest string that can be returned.
+          if (!ndbcHoldRow((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+            retVal = ndbcINTERNAL_ERROR;
+            ok = false;
+          }
+          data = false;
+          break;
+        }
+        ndbcArenaCommit(&arena, k);
+        // Fold this row's cost into the moving averages, seeding them with the first row measured.
+        now = uv_hrtime();
+        if (state->rowBytes == 0) {
+          state->rowTime = (double) (now - last);
+          state->rowBytes = k;
+        } else {
+          state->rowTime += ((double) (now - last) - state->rowTime) / 16;
+          state->rowBytes += ((double) k - state->rowBytes) / 16;
+        }
+        last = now;
+      }
+    }
+  }
+
+  if (ok) {
+    // Copy the formatted data to the output.
+    ndbcArenaToString(&arena, retVal);
+  }
+  // Free allocated memory resources.
+  ndbcFreeRowBuffer(&rowBuf);
+  ndbcFreeArena(&arena);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonDataScroll
+ * ndbcJsonDataScroll(statement, rowdesc, orientation, [offset], [rows])
+ * statement - An statement handle that has an available result set with a scrollable cursor
+ *             (see SQL_ATTR_CURSOR_SCROLLABLE and SQL_ATTR_CURSOR_TYPE).
+ * rowdesc - The row descriptor produced by ndbcJsonDescribe, or its rowDesc string.
+ * orientation - Where to position the cursor before the first row is output.
+ *               Strings representing API constants will be translated into their constant values.
+ *   SQL_FETCH_NEXT: The next row, as ndbcJsonData.
+ *   SQL_FETCH_PRIOR: The row before the current row.
+ *   SQL_FETCH_FIRST: The first row of the result set.
+ *   SQL_FETCH_LAST: The last row of the result set.
+ *   SQL_FETCH_ABSOLUTE: Row number <offset>, starting at 1.  Negative offsets count back from the end.
+ *   SQL_FETCH_RELATIVE: <offset> rows from the current row.
+ * offset - The row number or number of rows for SQL_FETCH_ABSOLUTE and SQL_FETCH_RELATIVE.  Defaults to 0.
+ * rows - The number of rows to output, the first at the new position and the rest following it.  Defaults to 1.
+ *        0 outputs every remaining row of the result set.
+ *
+ * Returns rows in the same format as ndbcJsonData, so a page of a result set can be read without re-executing
+ * the query or fetching and discarding the rows before it, eg. page n of size p is
+ * ndbcJsonDataScroll(statement, rowdesc, 'SQL_FETCH_ABSOLUTE', (n * p) + 1, p).
+ * A row held back by ndbcJsonData is discarded unless orientation is SQL_FETCH_NEXT.
+ * Returns SQL_NO_DATA if the cursor is positioned outside the result set.
+ */
+Handle<Value> ndbcJsonDataScroll(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  ndbcRowBuffer rowBuf;
+  ndbcArena arena = { NULL, NULL, 0 };
+  SQLSMALLINT orientation = SQL_FETCH_NEXT;
+  SQLLEN offset = 0;
+  SQLUINTEGER rows = 1;
+  SQLUINTEGER i;
+  size_t k;
+  char* recData;
+  bool ok = true;
+  bool data = true;
+
+  rowBuf.statement = NULL;
+  rowBuf.parsed = NULL;
+  if (args[2]->ToString() == ndbcSQL_FETCH_NEXT) {
+    orientation = SQL_FETCH_NEXT;
+  } else if (args[2]->ToString() == ndbcSQL_FETCH_PRIOR) {
+    orientation = SQL_FETCH_PRIOR;
+  } else if (args[2]->ToString() == ndbcSQL_FETCH_FIRST) {
+    orientation = SQL_FETCH_FIRST;
+  } else if (args[2]->ToString() == ndbcSQL_FETCH_LAST) {
+    orientation = SQL_FETCH_LAST;
+  } else if (args[2]->ToString() == ndbcSQL_FETCH_ABSOLUTE) {
+    orientation = SQL_FETCH_ABSOLUTE;
+  } else if (args[2]->ToString() == ndbcSQL_FETCH_RELATIVE) {
+    orientation = SQL_FETCH_RELATIVE;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args.Length() >= 4) {
+    offset = (SQLLEN) args[3]->IntegerValue();
+  }
+  if (args.Length() >= 5) {
+    rows = (SQLUINTEGER) args[4]->Uint32Value();
+  }
+
+  if (ok) {
+    // Bind the result set columns as laid out by the row description.
+    ok = ndbcBindRowDesc((SQLHANDLE) External::Unwrap(args[0]), args[1], &rowBuf, retVal);
+  }
+
+  if (ok) {
+    // Position the cursor with the first fetch, then fetch the following rows.
+    for (i = 0; ok && data && (rows == 0 || i < rows); i++) {
+      switch (ndbcFetchScroll((SQLHANDLE) External::Unwrap(args[0]), &rowBuf, (i == 0) ? orientation : SQL_FETCH_NEXT, (i == 0) ? offset : 0)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        ok = false;
+        break;
+      case SQL_STILL_EXECUTING:
+        retVal = ndbcSQL_STILL_EXECUTING;
+        ok = false;
+        break;
+      case SQL_NO_DATA:
+        // Return SQL_NO_DATA if no data has been read so far.
+        if (arena.len > 0) {
+          data = false;
+        } else {
+          retVal = ndbcSQL_NO_DATA;
+          ok = false;
+        }
+        break;
+      default:
+        // Reserve room for a full row in the output arena.
+        recData = ndbcArenaReserve(&arena, rowBuf.recLen);
+        if (recData == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        k = ndbcWriteRow(recData, &rowBuf);
+        if (arena.len > 0 && arena.len + k > ndbcMaxString) {
+          // Hold the row back for the next call rather than exceed the longest string that can be returned.
+          if (!ndbcHoldRow((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+            retVal = ndbcINTERNAL_ERROR;
+            ok = false;
+          }
+          data = false;
+          break;
+        }
+        ndbcArenaCommit(&arena, k);
+      }
+    }
+  }
+
+  if (ok) {
+    // Copy the formatted data to the output.
+    ndbcArenaToString(&arena, retVal);
+  }
+  // Free allocated memory resources.
+  ndbcFreeRowBuffer(&rowBuf);
+  ndbcFreeArena(&arena);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonColumnData
+ * ndbcJsonColumnData(statement, rowdesc, [rows], [dictionary])
+ * statement - An statement handle that has an available result set.
+ * rowdesc - The row descriptor produced by ndbcJsonDescribe, or its rowDesc string.
+ * rows - The number of rows to output.  Defaults to 1.
+ * dictionary - Selects the quoted columns to dictionary-encode.  Defaults to none.
+ *   true: Dictionary-encode every quoted column.
+ *   An array of column numbers (starting at 1): Dictionary-encode the listed quoted columns.
+ *
+ * Returns the next <rows> rows of the result set as a Json-formatted array of columns, each column being
+ * an array of that column's values in row order.
+ * A dictionary-encoded column is returned as an object instead, {"d":[values],"c":[codes]}, where d holds each
+ * distinct value of the column once and c holds an index into d (or null) for each row.
+ * Codes are only meaningful within the call that returned them.
+ * Returns truncated results if the number of remaining rows is less than the number of requested rows.
+ * Returns SQL_NO_DATA if the end of the result set has already been reached.
+ */
+Handle<Value> ndbcJsonColumnData(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  ndbcRowBuffer rowBuf;
+  ndbcBuffer* colData = NULL;
+  ndbcDictionary** dict = NULL;
+  SQLUINTEGER i;
+  SQLUINTEGER r = 0;
+  SQLUSMALLINT j;
+  size_t k;
+  SQLUINTEGER rows;
+  size_t start;
+  SQLUINTEGER code;
+  size_t outLen;
+  char* recData = NULL;
+  bool ok = true;
+  bool data = true;
+
+  if (args.Length() >= 3) {
+    rows = (SQLUINTEGER) args[2]->Uint32Value();
+  } else {
+    rows = 1;
+  }
+
+  // Bind the result set columns as laid out by the row description.
+  ok = ndbcBindRowDesc((SQLHANDLE) External::Unwrap(args[0]), args[1], &rowBuf, retVal);
+
+  if (ok) {
+    // Allocate a growable output buffer for each column and a dictionary for each encoded column.
+    colData = (ndbcBuffer*) calloc(rowBuf.columns, sizeof(ndbcBuffer));
+    dict = (ndbcDictionary**) calloc(rowBuf.columns, sizeof(ndbcDictionary*));
+    if (args.Length() >= 4 && args[3]->IsArray()) {
+      Local<Array> encode = Local<Array>::Cast(args[3]);
+      for (i = 0; i < encode->Length(); i++) {
+        j = (SQLUSMALLINT) encode->Get(i)->Uint32Value();
+        if (j >= 1 && j <= rowBuf.columns && rowBuf.serialize[j - 1] == 'q' && dict[j - 1] == NULL) {
+          dict[j - 1] = (ndbcDictionary*) calloc(1, sizeof(ndbcDictionary));
+        }
+      }
+    } else if (args.Length() >= 4 && args[3]->BooleanValue()) {
+      for (j = 0; j < rowBuf.columns; j++) {
+        if (rowBuf.serialize[j] == 'q') {
+          dict[j] = (ndbcDictionary*) calloc(1, sizeof(ndbcDictionary));
+        }
+      }
+    }
+
+    // Fetch the specified number of rows.
+    for (i = 0; ok && data && i < rows; i++) {
+      switch (ndbcFetch((SQLHANDLE) External::Unwrap(args[0]), &rowBuf)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        ok = false;
+        break;
+      case SQL_STILL_EXECUTING:
+        retVal = ndbcSQL_STILL_EXECUTING;
+        ok = false;
+        break;
+      case SQL_NO_DATA:
+        // Return SQL_NO_DATA if no data has been read so far.
+        if (r > 0) {
+          data = false;
+        } else {
+          retVal = ndbcSQL_NO_DATA;
+          ok = false;
+        }
+        break;
+      default:
+        // Append each field to its column, preceded by a comma after the first row.
+        // The worst case field is twice the column length plus quotes (base64 and null are shorter).
+        for (j = 0; ok && j < rowBuf.columns; j++) {
+          if (!ndbcBufferReserve(&colData[j], ((size_t) rowBuf.rowLen[j] * 2) + 12)) {
+            retVal = ndbcINTERNAL_ERROR;
+            ok = false;
+            break;
+          }
+          if (r > 0) {
+            colData[j].data[colData[j].len] = ',';
+            colData[j].len++;
+          }
+          if (dict[j] == NULL || *rowBuf.rowInd[j] == SQL_NULL_DATA) {
+            colData[j].len += ndbcWriteField(colData[j].data + colData[j].len, &rowBuf, j);
+          } else {
+            // Serialize the value at the end of the dictionary, where it is kept only if it is new.
+            if (!ndbcBufferReserve(&dict[j]->values, ((size_t) rowBuf.rowLen[j] * 2) + 3)) {
+              retVal = ndbcINTERNAL_ERROR;
+              ok = false;
+              break;
+            }
+            start = dict[j]->values.len;
+            if (dict[j]->count > 0) {
+              dict[j]->values.data[start] = ',';
+              start++;
+            }
+            code = ndbcDictionaryCode(dict[j], start, ndbcWriteField(dict[j]->values.data + start, &rowBuf, j));
+            if (code == (SQLUINTEGER) -1) {
+              retVal = ndbcINTERNAL_ERROR;
+              ok = false;
+              break;
+            }
+            colData[j].len += ndbcWriteUnsigned(colData[j].data + colData[j].len, code);
+          }
+        }
+        r++;
+      }
+    }
+  }
+
+  if (ok) {
+    // Size the output exactly: enclosing braces, column arrays and separating commas, and dictionary wrappers.
+    outLen = 2 + rowBuf.columns;
+    for (j = 0; ok && j < rowBuf.columns; j++) {
+      ok = ndbcAddSize(&outLen, colData[j].len + 2);
+      if (ok && dict[j] != NULL) {
+        // {"d":[ + ],"c": + }
+        ok = ndbcAddSize(&outLen, dict[j]->values.len + 13);
+      }
+    }
+    if (ok && outLen <= ndbcMaxString) {
+      recData = (char*) malloc(outLen);
+    }
+    if (recData == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+
+  if (ok) {
+    k = 0;
+    recData[k] = '[';
+    k++;
+    for (j = 0; j < rowBuf.columns; j++) {
+      if (dict[j] != NULL) {
+        memcpy(recData + k, "{\"d\":[", 6);
+        k += 6;
+        memcpy(recData + k, dict[j]->values.data, dict[j]->values.len);
+        k += dict[j]->values.len;
+        memcpy(recData + k, "],\"c\":", 6);
+        k += 6;
+      }
+      recData[k] = '[';
+      k++;
+      memcpy(recData + k, colData[j].data, colData[j].len);
+      k += colData[j].len;
+      recData[k] = ']';
+      k++;
+      if (dict[j] != NULL) {
+        recData[k] = '}';
+        k++;
+      }
+      recData[k] = ',';
+      k++;
+    }
+    // Overwrite the last comma and terminate the column array.
+    if (rowBuf.columns > 0) {
+      k--;
+    }
+    recData[k] = ']';
+    k++;
+    // Copy the formatted data to the output.
+    retVal = String::New(recData, (int) k);
+  }
+
+  // Free allocated memory resources.
+  for (j = 0; colData != NULL && j < rowBuf.columns; j++) {
+    free(colData[j].data);
+    if (dict[j] != NULL) {
+      free(dict[j]->values.data);
+      free(dict[j]->offset);
+      free(dict[j]->length);
+      free(dict[j]->slots);
+      free(dict[j]);
+    }
+  }
+  free(colData);
+  free(dict);
+  ndbcFreeRowBuffer(&rowBuf);
+  free(recData);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcJsonTrailer
+ * ndbcJsonTrailer(statement)
+ * statement - An statement handle that has an available result set.
+ *
+ * Returns a trailing ] character to begin the array of records.
+ * Technically, the argument isn't required, but you can supply it if you like.
+ */
+Handle<Value> ndbcJsonTrailer(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+
+  retVal = String::New("]");
+  
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcBindParameters
+ * ndbcBindParameters(statement, params)
+ * statement - An statement handle created with SQLAllocHandle.
+ * params - An array holding a value for each parameter marker ('?') of the query, in order.
+ *          null, booleans, numbers, strings, Buffers and Dates are bound with matching SQL types.
+ *
+ * Binds the values as the statement's input parameters, for the next SQLExecDirect or for any number of
+ * SQLExecute calls on a prepared query.
+ * The values are copied natively and kept until parameters are next bound, so the query is sent with markers and
+ * its plan can be reused by the server, rather than built into the query text.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcBindParameters(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  if (ndbcBindParamValues((SQLHANDLE) External::Unwrap(args[0]), args[1], retVal)) {
+    retVal = ndbcSQL_SUCCESS;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcBindDataAtExec
+ * ndbcBindDataAtExec(statement, parameter, [type], [length])
+ * statement - An statement handle with a query prepared by SQLPrepare.
+ * parameter - The number of the parameter marker ('?') to bind, starting from 1.
+ * type - The parameter's SQL type: 'SQL_LONGVARBINARY', 'SQL_VARBINARY', 'SQL_LONGVARCHAR', 'SQL_VARCHAR' or
+ *        'SQL_WLONGVARCHAR'.  Binary types are sent as bytes.  Character types, 'SQL_WLONGVARCHAR' included, are
+ *        bound as SQL_C_CHAR, so the driver reads the bytes sent in the client code page; strings passed to
+ *        SQLPutData or PutStream are only read correctly where that code page is UTF-8.
+ *        Defaults to 'SQL_LONGVARBINARY'.
+ * length - The total length of the value in bytes, for drivers that need it in advance.  Defaults to unknown.
+ *
+ * Binds a parameter whose value is sent while the query runs, so large values never have to be held in memory.
+ * Bind any other parameters first with BindParameters, which replaces all bindings.
+ * When the query is run, SQLExecute returns 'SQL_NEED_DATA'.  SQLParamData then returns the number of the
+ * parameter whose data is needed, which is sent with SQLPutData or PutStream.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcBindDataAtExec(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcStatementState* state;
+  SQLUSMALLINT parameter = (SQLUSMALLINT) args[1]->Uint32Value();
+  SQLSMALLINT cType = SQL_C_BINARY;
+  SQLSMALLINT sqlType = SQL_LONGVARBINARY;
+  SQLLEN* ind = NULL;
+  bool ok = true;
+
+  if (parameter < 1 || args[1]->Uint32Value() > 32767
+      || (args.Length() >= 4 && !args[3]->IsUndefined() && args[3]->IntegerValue() < 0)) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args.Length() >= 3 && !args[2]->IsUndefined()) {
+    if (args[2]->ToString() == ndbcSQL_LONGVARBINARY) {
+      sqlType = SQL_LONGVARBINARY;
+    } else if (args[2]->ToString() == ndbcSQL_VARBINARY) {
+      sqlType = SQL_VARBINARY;
+    } else if (args[2]->ToString() == ndbcSQL_LONGVARCHAR) {
+      cType = SQL_C_CHAR;
+      sqlType = SQL_LONGVARCHAR;
+    } else if (args[2]->ToString() == ndbcSQL_VARCHAR) {
+      cType = SQL_C_CHAR;
+      sqlType = SQL_VARCHAR;
+    } else if (args[2]->ToString() == ndbcSQL_WLONGVARCHAR) {
+      cType = SQL_C_CHAR;
+      sqlType = SQL_WLONGVARCHAR;
+    } else {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+  }
+
+  if (ok) {
+    // The indicator is read when the query runs, so it lives with the statement's other parameter data.
+    state = ndbcGetStatementState((SQLHANDLE) External::Unwrap(args[0]), true);
+    if (state != NULL) {
+      ind = (SQLLEN*) ndbcArenaAlloc(&state->params, sizeof(SQLLEN));
+    }
+    if (ind == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+  if (ok) {
+    if (args.Length() >= 4 && !args[3]->IsUndefined()) {
+      *ind = SQL_LEN_DATA_AT_EXEC((SQLLEN) args[3]->IntegerValue());
+    } else {
+      *ind = SQL_DATA_AT_EXEC;
+    }
+    // The parameter number is bound as the value pointer, so SQLParamData returns it to identify the parameter.
+    switch (SQLBindParameter((SQLHANDLE) External::Unwrap(args[0]), parameter, SQL_PARAM_INPUT, cType, sqlType,
+                             (args.Length() >= 4 && !args[3]->IsUndefined()) ? (SQLULEN) args[3]->IntegerValue() : 0,
+                             0, (SQLPOINTER) (SQLULEN) parameter, 0, ind)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    default:
+      retVal = ndbcSQL_SUCCESS;
+    }
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal function ndbcParamsetLimit
+ * Returns the number of rows, up to batchSize, that a statement's driver takes in one parameter set.
+ * Drivers that do not support parameter arrays take 1, and drivers that substitute a smaller size take that size.
+ */
+SQLUINTEGER ndbcParamsetLimit(SQLHANDLE statement, SQLUINTEGER batchSize) {
+  SQLULEN paramsetSize = batchSize;
+
+  if (batchSize <= 1) {
+    return batchSize;
+  }
+  if (SQLSetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) paramsetSize, 0) == SQL_ERROR) {
+    return 1;
+  }
+  if (SQLGetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, &paramsetSize, 0, NULL) != SQL_ERROR
+      && paramsetSize >= 1 && paramsetSize < batchSize) {
+    return (SQLUINTEGER) paramsetSize;
+  }
+  return batchSize;
+}
+
+/* ndbc internal function ndbcExternalArrayType
+ * Gives the C type, SQL type, column size and element size to bind the elements of a typed array with.
+ * type is the array's V8 ExternalArrayType.  Unsigned types are bound to an SQL type wide enough for their range.
+ * Returns false for types that can not be bound.
+ */
+bool ndbcExternalArrayType(int type, SQLSMALLINT* cType, SQLSMALLINT* sqlType, SQLULEN* size, size_t* elemSize) {
+  switch (type) {
+  case kExternalByteArray:
+    *cType = SQL_C_STINYINT;
+    *sqlType = SQL_TINYINT;
+    *size = 3;
+    *elemSize = 1;
+    return true;
+  case kExternalUnsignedByteArray:
+  case kExternalPixelArray:
+    *cType = SQL_C_UTINYINT;
+    *sqlType = SQL_SMALLINT;
+    *size = 5;
+    *elemSize = 1;
+    return true;
+  case kExternalShortArray:
+    *cType = SQL_C_SSHORT;
+    *sqlType = SQL_SMALLINT;
+    *size = 5;
+    *elemSize = 2;
+    return true;
+  case kExternalUnsignedShortArray:
+    *cType = SQL_C_USHORT;
+    *sqlType = SQL_INTEGER;
+    *size = 10;
+    *elemSize = 2;
+    return true;
+  case kExternalIntArray:
+    *cType = SQL_C_SLONG;
+    *sqlType = SQL_INTEGER;
+    *size = 10;
+    *elemSize = 4;
+    return true;
+  case kExternalUnsignedIntArray:
+    *cType = SQL_C_ULONG;
+    *sqlType = SQL_BIGINT;
+    *size = 19;
+    *elemSize = 4;
+    return true;
+  case kExternalFloatArray:
+    *cType = SQL_C_FLOAT;
+    *sqlType = SQL_REAL;
+    *size = 7;
+    *elemSize = 4;
+    return true;
+  case kExternalDoubleArray:
+    *cType = SQL_C_DOUBLE;
+    *sqlType = SQL_DOUBLE;
+    *size = 15;
+    *elemSize = 8;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* ndbc internal function ndbcParamStatusName
+ * Returns the string representation of a parameter status array value.
+ */
+Local<Value> ndbcParamStatusName(SQLUSMALLINT status) {
+  switch (status) {
+  case SQL_PARAM_SUCCESS:
+    return ndbcSQL_PARAM_SUCCESS;
+  case SQL_PARAM_SUCCESS_WITH_INFO:
+    return ndbcSQL_PARAM_SUCCESS_WITH_INFO;
+  case SQL_PARAM_ERROR:
+    return ndbcSQL_PARAM_ERROR;
+  case SQL_PARAM_UNUSED:
+    return ndbcSQL_PARAM_UNUSED;
+  default:
+    return ndbcSQL_PARAM_DIAG_UNAVAILABLE;
+  }
+}
+
+/* ndbc internal function ndbcRowStatusName
+ * Returns the name of a row status array value.
+ */
+Local<Value> ndbcRowStatusName(SQLUSMALLINT status) {
+  switch (status) {
+  case SQL_ROW_SUCCESS:
+    return ndbcSQL_ROW_SUCCESS;
+  case SQL_ROW_SUCCESS_WITH_INFO:
+    return ndbcSQL_ROW_SUCCESS_WITH_INFO;
+  case SQL_ROW_ERROR:
+    return ndbcSQL_ROW_ERROR;
+  case SQL_ROW_UPDATED:
+    return ndbcSQL_ROW_UPDATED;
+  case SQL_ROW_DELETED:
+    return ndbcSQL_ROW_DELETED;
+  case SQL_ROW_ADDED:
+    return ndbcSQL_ROW_ADDED;
+  default:
+    return ndbcSQL_ROW_NOROW;
+  }
+}
+
+/* ndbc internal function ndbcCheckParamRows
+ * Checks that a javascript array of rows can be bound as parameter arrays by ndbcBindParamArrays: every row is an
+ * array with the same number of values, and the values for each parameter share a kind across all of the rows.
+ * Returns false and sets retVal to the error string otherwise.
+ */
+bool ndbcCheckParamRows(Local<Array> rows, Local<Value>& retVal) {
+  Local<Value> row;
+  SQLUINTEGER columns;
+  SQLUINTEGER i;
+  SQLUINTEGER r;
+  char* kind;
+  bool ok = true;
+
+  if (rows->Length() == 0) {
+    return true;
+  }
+  row = rows->Get(0);
+  if (!row->IsArray() || Local<Array>::Cast(row)->Length() > 32767) {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  columns = Local<Array>::Cast(row)->Length();
+  kind = (char*) malloc(columns + 1);
+  if (kind == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  memset(kind, 'n', columns);
+  for (r = 0; ok && r < rows->Length(); r++) {
+    row = rows->Get(r);
+    if (!row->IsArray() || Local<Array>::Cast(row)->Length() != columns) {
+      ok = false;
+      break;
+    }
+    for (i = 0; ok && i < columns; i++) {
+      kind[i] = ndbcWidenParamKind(kind[i], ndbcParamKind(Local<Array>::Cast(row)->Get(i)));
+      ok = (kind[i] != 0);
+    }
+  }
+  free(kind);
+  if (!ok) {
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  return ok;
+}
+
+/* ndbc internal function ndbcExecParamBatches
+ * Runs a prepared query once for each of a javascript array of rows, as described for ndbcExecBatch, sending up to
+ * batchSize rows in each execution.
+ * Every row is checked before anything is run, so invalid rows never leave part of the array run.
+ * Returns true and sets retVal to the array of row statuses if any rows were run, even if a later batch failed.
+ * Returns false and sets retVal to the error string if the rows are invalid or nothing could be run.
+ */
+bool ndbcExecParamBatches(SQLHANDLE statement, Local<Array> rows, SQLUINTEGER batchSize, Local<Value>& retVal) {
+  ndbcStatementState* state;
+  Local<Array> status = Array::New(rows->Length());
+  SQLUINTEGER first;
+  SQLUINTEGER count;
+  SQLUINTEGER r;
+  bool ran = false;
+  bool ok = true;
+
+  if (!ndbcCheckParamRows(rows, retVal)) {
+    return false;
+  }
+  batchSize = ndbcParamsetLimit(statement, batchSize);
+
+  for (first = 0; ok && first < rows->Length(); first += count) {
+    count = (rows->Length() - first < batchSize) ? rows->Length() - first : batchSize;
+    if (first > 0) {
+      SQLFreeStmt(statement, SQL_CLOSE);
+    }
+    ok = ndbcBindParamArrays(statement, rows, first, count, false, retVal);
+    if (!ok) {
+      // Earlier batches have run, so their statuses are kept and the batch that could not be sent fails.
+      for (r = 0; ran && r < count; r++) {
+        status->Set(first + r, ndbcSQL_PARAM_ERROR);
+      }
+      break;
+    }
+    state = ndbcGetStatementState(statement, false);
+    for (r = 0; r < count; r++) {
+      state->paramStatus[r] = SQL_PARAM_UNUSED;
+    }
+    *state->paramsProcessed = 0;
+    ndbcResetStatementState(statement);
+    switch (SQLExecute(statement)) {
+    case SQL_ERROR:
+      // The statuses show which rows failed, as long as the driver got as far as processing any.
+      // A batch that failed as a whole fails the call if it is the first batch.
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      ran = ran || *state->paramsProcessed > 0;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    default:
+      // Drivers that do not report per-row statuses ran every row.
+      if (*state->paramsProcessed == 0) {
+        for (r = 0; r < count; r++) {
+          state->paramStatus[r] = SQL_PARAM_SUCCESS;
+        }
+      }
+      ran = true;
+    }
+    if (!ok && ran && *state->paramsProcessed == 0) {
+      // Failures that give no row statuses, after earlier batches ran, fail every row of the batch.
+      for (r = 0; r < count; r++) {
+        state->paramStatus[r] = SQL_PARAM_ERROR;
+      }
+    }
+    if (ran) {
+      for (r = 0; r < count; r++) {
+        status->Set(first + r, ndbcParamStatusName(state->paramStatus[r]));
+      }
+    }
+  }
+
+  if (ok || ran) {
+    // Mark the rows after a failed batch as not run.
+    for (r = 0; r < rows->Length(); r++) {
+      if (status->Get(r)->IsUndefined()) {
+        status->Set(r, ndbcSQL_PARAM_UNUSED);
+      }
+    }
+    retVal = status;
+    return true;
+  }
+  return false;
+}
+
+/* ndbc custom function ndbcExecBatch
+ * ndbcExecBatch(statement, rows, [batchSize])
+ * statement - An statement handle with a query prepared by SQLPrepare.
+ * rows - An array of rows, each an array holding a value for each parameter marker ('?') of the query, in order.
+ *        Values are bound as by ndbcBindParameters.  The values for each parameter must share a type, apart from
+ *        nulls, and numbers, which widen to fit every row.
+ * batchSize - The number of rows sent to the server in each execution.  Defaults to 1000.
+ *
+ * Runs the prepared query once for each row, packing the rows into column-wise parameter arrays
+ * (SQL_ATTR_PARAMSET_SIZE) so each round trip to the server carries a whole batch.
+ * If the driver does not support parameter arrays, or supports smaller ones, smaller batches are sent.
+ * Any result sets produced by a batch are closed before the next batch is sent.
+ * Every row is checked before the first batch is sent.  Stops after the first batch that fails.
+ * Returns an array with the status of each row from the parameter status array: 'SQL_PARAM_SUCCESS',
+ * 'SQL_PARAM_SUCCESS_WITH_INFO', 'SQL_PARAM_ERROR', 'SQL_PARAM_UNUSED' for rows that were not run, or
+ * 'SQL_PARAM_DIAG_UNAVAILABLE'.
+ * Once any batch has run, the status array is always returned, so the rows already written are known: a later batch
+ * that fails without giving row statuses, or can not be sent, has every row marked 'SQL_PARAM_ERROR'.
+ * If the rows are invalid or nothing could be run, returns a string describing the error instead.  Use typeof to
+ * determine success.
+ */
+Handle<Value> ndbcExecBatch(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLUINTEGER batchSize = 1000;
+  bool ok = true;
+
+  if (!args[1]->IsArray()) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args.Length() >= 3 && !args[2]->IsUndefined()) {
+    batchSize = args[2]->Uint32Value();
+    if (batchSize < 1) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+  }
+
+  if (ok) {
+    ndbcExecParamBatches((SQLHANDLE) External::Unwrap(args[0]), Local<Array>::Cast(args[1]), batchSize, retVal);
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcExecColumns
+ * ndbcExecColumns(statement, columns, [nulls], [batchSize])
+ * statement - An statement handle with a query prepared by SQLPrepare.
+ * columns - An array holding a typed array (Int8Array, Uint8Array, Int16Array, Uint16Array, Int32Array, Uint32Array,
+ *           Float32Array or Float64Array, or a Buffer) for each parameter marker ('?') of the query, in order.
+ *           Element n of each array is the parameter's value for row n.  All arrays must have the same length.
+ * nulls - An array holding a null bitmap for each column, or null / undefined for columns without nulls.
+ *         Each bitmap is a Uint8Array or Buffer where bit (n % 8) of byte (n / 8) is set if row n is null.
+ *         Defaults to no nulls.
+ * batchSize - The number of rows sent to the server in each execution.  Defaults to 1000.
+ *
+ * Runs the prepared query once for each row, as ndbcExecBatch, with the parameters bound directly to the typed
+ * arrays' memory.  No javascript values are created and no column data is copied, only indicators for columns with
+ * null bitmaps.  The bindings are released before returning, so the arrays are not referenced afterwards.
+ * Stops after the first batch that fails.
+ * Returns an object:
+ *   processed - The number of rows run.  Rows from this index on were not run.
+ *   errors - An array holding the index of each row that failed.
+ * If nothing could be run, returns a string describing the error instead.  Use typeof to determine success.
+ */
+Handle<Value> ndbcExecColumns(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcStatementState* state = NULL;
+  Local<Array> columns;
+  Local<Array> nulls;
+  Local<Object> column;
+  Local<Object> bitmap;
+  Local<Array> errors = Array::New();
+  Local<Object> result;
+  SQLSMALLINT cType;
+  SQLSMALLINT sqlType;
+  SQLULEN size;
+  size_t elemSize;
+  SQLUINTEGER batchSize = 1000;
+  SQLUINTEGER rows = 0;
+  SQLUINTEGER processed = 0;
+  SQLUINTEGER failures = 0;
+  SQLUINTEGER first;
+  SQLUINTEGER count;
+  SQLUINTEGER i;
+  SQLUINTEGER r;
+  unsigned char* bits;
+  SQLLEN* ind;
+  bool ran = false;
+  bool ok = true;
+
+  // Check that every column is a typed array of the same length, and every null bitmap covers the rows.
+  if (!args[1]->IsArray() || Local<Array>::Cast(args[1])->Length() < 1 || Local<Array>::Cast(args[1])->Length() > 32767) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  } else {
+    columns = Local<Array>::Cast(args[1]);
+  }
+  if (ok && args.Length() >= 3 && !args[2]->IsUndefined() && !args[2]->IsNull()) {
+    if (!args[2]->IsArray()) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    } else {
+      nulls = Local<Array>::Cast(args[2]);
+    }
+  }
+  if (args.Length() >= 4 && !args[3]->IsUndefined()) {
+    batchSize = args[3]->Uint32Value();
+    if (batchSize < 1) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+  }
+  for (i = 0; ok && i < columns->Length(); i++) {
+    if (!columns->Get(i)->IsObject() || !columns->Get(i)->ToObject()->HasIndexedPropertiesInExternalArrayData()) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+      break;
+    }
+    column = columns->Get(i)->ToObject();
+    if (i == 0) {
+      rows = column->GetIndexedPropertiesExternalArrayDataLength();
+    }
+    if ((SQLUINTEGER) column->GetIndexedPropertiesExternalArrayDataLength() != rows
+        || !ndbcExternalArrayType(column->GetIndexedPropertiesExternalArrayDataType(), &cType, &sqlType, &size, &elemSize)) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+      break;
+    }
+    if (!nulls.IsEmpty() && !nulls->Get(i)->IsUndefined() && !nulls->Get(i)->IsNull()) {
+      if (!nulls->Get(i)->IsObject() || !nulls->Get(i)->ToObject()->HasIndexedPropertiesInExternalArrayData()) {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+        break;
+      }
+      bitmap = nulls->Get(i)->ToObject();
+      if ((bitmap->GetIndexedPropertiesExternalArrayDataType() != kExternalUnsignedByteArray
+           && bitmap->GetIndexedPropertiesExternalArrayDataType() != kExternalByteArray)
+          || (SQLUINTEGER) bitmap->GetIndexedPropertiesExternalArrayDataLength() < (rows + 7) / 8) {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+        break;
+      }
+    }
+  }
+
+  if (ok) {
+    state = ndbcGetStatementState((SQLHANDLE) External::Unwrap(args[0]), true);
+    if (state == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+  if (ok) {
+    batchSize = ndbcParamsetLimit((SQLHANDLE) External::Unwrap(args[0]), batchSize);
+  }
+
+  for (first = 0; ok && first < rows; first += count) {
+    count = (rows - first < batchSize) ? rows - first : batchSize;
+    if (first > 0) {
+      SQLFreeStmt((SQLHANDLE) External::Unwrap(args[0]), SQL_CLOSE);
+    }
+    // Size the parameter set to the batch, keeping only the statuses and indicators natively.
+    SQLFreeStmt((SQLHANDLE) External::Unwrap(args[0]), SQL_RESET_PARAMS);
+    ndbcArenaReset(&state->params);
+    state->paramStatus = (SQLUSMALLINT*) ndbcArenaAlloc(&state->params, sizeof(SQLUSMALLINT) * count);
+    state->paramsProcessed = (SQLULEN*) ndbcArenaAlloc(&state->params, sizeof(SQLULEN));
+    if (state->paramStatus == NULL || state->paramsProcessed == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+      break;
+    }
+    if (SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0) == SQL_ERROR
+        || SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (SQLULEN) count, 0) == SQL_ERROR) {
+      if (count > 1) {
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      }
+    }
+    SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAM_STATUS_PTR, (SQLPOINTER) state->paramStatus, 0);
+    SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAMS_PROCESSED_PTR, (SQLPOINTER) state->paramsProcessed, 0);
+    // Point each parameter at the batch's rows within its typed array.
+    for (i = 0; ok && i < columns->Length(); i++) {
+      column = columns->Get(i)->ToObject();
+      ndbcExternalArrayType(column->GetIndexedPropertiesExternalArrayDataType(), &cType, &sqlType, &size, &elemSize);
+      ind = NULL;
+      if (!nulls.IsEmpty() && !nulls->Get(i)->IsUndefined() && !nulls->Get(i)->IsNull()) {
+        bits = (unsigned char*) nulls->Get(i)->ToObject()->GetIndexedPropertiesExternalArrayData();
+        ind = (SQLLEN*) ndbcArenaAlloc(&state->params, sizeof(SQLLEN) * count);
+        if (ind == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
+          break;
+        }
+        for (r = 0; r < count; r++) {
+          ind[r] = ((bits[(first + r) >> 3] >> ((first + r) & 7)) & 1) ? SQL_NULL_DATA : (SQLLEN) elemSize;
+        }
+      }
+      switch (SQLBindParameter((SQLHANDLE) External::Unwrap(args[0]), (SQLUSMALLINT) (i + 1), SQL_PARAM_INPUT, cType, sqlType,
+                               size, 0, (SQLPOINTER) ((char*) column->GetIndexedPropertiesExternalArrayData() + (first * elemSize)),
+                               (SQLLEN) elemSize, ind)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        ok = false;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        ok = false;
+        break;
+      }
+    }
+    if (!ok) {
+      break;
+    }
+    for (r = 0; r < count; r++) {
+      state->paramStatus[r] = SQL_PARAM_UNUSED;
+    }
+    *state->paramsProcessed = 0;
+    ndbcResetStatementState((SQLHANDLE) External::Unwrap(args[0]));
+    switch (SQLExecute((SQLHANDLE) External::Unwrap(args[0]))) {
+    case SQL_ERROR:
+      // A batch that failed as a whole fails every row, or the call if it is the first batch.
+      ok = false;
+      if (*state->paramsProcessed == 0) {
+        if (!ran) {
+          retVal = ndbcSQL_ERROR;
           break;
-        case SQL_REAL:
-          *dataLen = 14;
-          recLen += 15;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
+        }
+        for (r = 0; r < count; r++) {
+          state->paramStatus[r] = SQL_PARAM_ERROR;
+        }
+        *state->paramsProcessed = count;
+      }
+      ran = true;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    default:
+      // Drivers that do not report per-row statuses ran every row.
+      if (*state->paramsProcessed == 0) {
+        *state->paramsProcessed = count;
+      }
+      ran = true;
+    }
+    if (ran) {
+      for (r = 0; r < count && r < *state->paramsProcessed; r++) {
+        if (state->paramStatus[r] == SQL_PARAM_ERROR) {
+          errors->Set(failures, Integer::NewFromUnsigned(first + r));
+          failures++;
+        }
+      }
+      processed = first + (SQLUINTEGER) ((*state->paramsProcessed < count) ? *state->paramsProcessed : count);
+    }
+  }
+
+  // Release the bindings, which point into the typed arrays, and the status pointers, which point into the
+  // statement's parameter memory, so later executions of the statement write to neither.
+  SQLFreeStmt((SQLHANDLE) External::Unwrap(args[0]), SQL_RESET_PARAMS);
+  SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAM_STATUS_PTR, NULL, 0);
+  SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, 0);
+  SQLSetStmtAttr((SQLHANDLE) External::Unwrap(args[0]), SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+  if (state != NULL) {
+    ndbcArenaReset(&state->params);
+    state->paramStatus = NULL;
+    state->paramsProcessed = NULL;
+  }
+
+  if (ok || ran) {
+    result = Object::New();
+    result->Set(String::NewSymbol("processed"), Integer::NewFromUnsigned(processed));
+    result->Set(String::NewSymbol("errors"), errors);
+    retVal = result;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcBindRowset
+ * ndbcBindRowset(statement, rows)
+ * statement - An statement handle with an open cursor.
+ * rows - An array of rows, each an array holding a value for each column of the cursor, in order.
+ *        Values are bound as by ndbcBindParameters.  The values for each column must share a type, apart from
+ *        nulls, and numbers, which widen to fit every row.
+ *
+ * Binds the rows as the columns of the cursor's rowset (column-wise, with SQL_ATTR_ROW_ARRAY_SIZE set to the number
+ * of rows), for SQLBulkOperations to insert with 'SQL_ADD' or SQLSetPos to write with 'SQL_UPDATE'.
+ * Any earlier column bindings are released.  The values are kept with the statement until columns are next bound.
+ * The rowset is only written from, never fetched into: JsonData and the other fetch functions release it and fetch
+ * one row at a time.  To update a fetched row, fetch it with JsonData, bind its new values as a rowset of one row,
+ * then call SQLSetPos(statement, 1, 'SQL_UPDATE').  SQLSetPos with 'SQL_DELETE' needs no rowset.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * Any other return value indicates failure.
+ */
+Handle<Value> ndbcBindRowset(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  if (!args[1]->IsArray() || Local<Array>::Cast(args[1])->Length() < 1) {
+    retVal = ndbcINVALID_ARGUMENT;
+  } else if (ndbcBindParamArrays((SQLHANDLE) External::Unwrap(args[0]), Local<Array>::Cast(args[1]), 0,
+                                 Local<Array>::Cast(args[1])->Length(), true, retVal)) {
+    retVal = ndbcSQL_SUCCESS;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcRowStatus
+ * ndbcRowStatus(statement)
+ * statement - An statement handle with a rowset bound by BindRowset.
+ *
+ * Returns an array with the status of each row of the rowset after the last SQLBulkOperations, SQLSetPos or fetch:
+ * 'SQL_ROW_SUCCESS', 'SQL_ROW_SUCCESS_WITH_INFO', 'SQL_ROW_ERROR', 'SQL_ROW_UPDATED', 'SQL_ROW_DELETED',
+ * 'SQL_ROW_ADDED' or 'SQL_ROW_NOROW'.
+ * Returns an empty array if no rowset is bound.
+ */
+Handle<Value> ndbcRowStatus(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcStatementState* state = ndbcGetStatementState((SQLHANDLE) External::Unwrap(args[0]), false);
+  Local<Array> status;
+  SQLUINTEGER r;
+
+  if (state == NULL || state->rowStatus == NULL) {
+    retVal = Array::New(0);
+  } else {
+    status = Array::New(state->rowsetSize);
+    for (r = 0; r < state->rowsetSize; r++) {
+      status->Set(r, ndbcRowStatusName(state->rowStatus[r]));
+    }
+    retVal = status;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal function ndbcBulkAdd
+ * Inserts a javascript array of rows with SQLBulkOperations, through a keyset-driven cursor opened on select,
+ * binding up to batchSize rows at a time as the cursor's rowset.
+ * Returns true and sets retVal to the array of row statuses, named as parameter statuses, or to the error string.
+ * Returns false if the driver could not open the cursor or refused the first batch before adding any rows,
+ * so the rows can be sent another way.
+ */
+bool ndbcBulkAdd(SQLHANDLE statement, SQLCHAR* select, SQLINTEGER selectLen, Local<Array> rows, SQLUINTEGER batchSize,
+                 Local<Value>& retVal) {
+  ndbcStatementState* state;
+  Local<Array> status = Array::New(rows->Length());
+  SQLULEN cursorType = 0;
+  SQLUINTEGER first;
+  SQLUINTEGER count;
+  SQLUINTEGER r;
+  bool sent;
+  bool ran = false;
+  bool ok = true;
+
+  if (SQLSetStmtAttr(statement, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0) == SQL_ERROR
+      || SQLSetStmtAttr(statement, SQL_ATTR_CONCURRENCY, (SQLPOINTER) SQL_CONCUR_LOCK, 0) == SQL_ERROR
+      || SQLExecDirect(statement, select, selectLen) == SQL_ERROR
+      || SQLGetStmtAttr(statement, SQL_ATTR_CURSOR_TYPE, &cursorType, 0, NULL) == SQL_ERROR
+      || cursorType != SQL_CURSOR_KEYSET_DRIVEN) {
+    // The driver substituted another cursor type, which need not support bulk operations.
+    return false;
+  }
+
+  for (first = 0; ok && first < rows->Length(); first += count) {
+    count = (rows->Length() - first < batchSize) ? rows->Length() - first : batchSize;
+    if (!ndbcBindParamArrays(statement, rows, first, count, true, retVal)) {
+      if (!ran) {
+        return false;
+      }
+      break;
+    }
+    state = ndbcGetStatementState(statement, false);
+    for (r = 0; r < count; r++) {
+      state->rowStatus[r] = SQL_ROW_NOROW;
+    }
+    sent = false;
+    switch (SQLBulkOperations(statement, SQL_ADD)) {
+    case SQL_ERROR:
+      // Rows the driver added before failing must not be sent again, so only fall back if there are none.
+      ok = false;
+      for (r = 0; r < count; r++) {
+        if (state->rowStatus[r] != SQL_ROW_NOROW) {
+          sent = true;
+        }
+      }
+      if (!sent) {
+        if (!ran) {
+          return false;
+        }
+        for (r = 0; r < count; r++) {
+          state->rowStatus[r] = SQL_ROW_ERROR;
+        }
+        sent = true;
+      }
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    default:
+      sent = true;
+    }
+    if (!sent) {
+      if (!ran) {
+        return true;
+      }
+      break;
+    }
+    ran = true;
+    for (r = 0; r < count; r++) {
+      switch (state->rowStatus[r]) {
+      case SQL_ROW_SUCCESS_WITH_INFO:
+        status->Set(first + r, ndbcSQL_PARAM_SUCCESS_WITH_INFO);
+        break;
+      case SQL_ROW_ERROR:
+        status->Set(first + r, ndbcSQL_PARAM_ERROR);
+        break;
+      case SQL_ROW_NOROW:
+        // Drivers that do not report per-row statuses added every row of a successful batch.
+        status->Set(first + r, ok ? ndbcSQL_PARAM_SUCCESS : ndbcSQL_PARAM_UNUSED);
+        break;
+      default:
+        status->Set(first + r, ndbcSQL_PARAM_SUCCESS);
+      }
+    }
+  }
+
+  // Mark the rows after a failed batch as not run.
+  for (r = 0; r < rows->Length(); r++) {
+    if (status->Get(r)->IsUndefined()) {
+      status->Set(r, ndbcSQL_PARAM_UNUSED);
+    }
+  }
+  retVal = status;
+  return true;
+}
+
+/* ndbc custom function ndbcBulkWrite
+ * ndbcBulkWrite(connection, operation, table, columns, rows, [keys], [batchSize])
+ * connection - A connection handle connected with SQLConnect.
+ * operation - One of the following strings:
+ *   SQL_ADD: Inserts each row.
+ *   SQL_UPDATE: Sets the non-key columns of the table row whose key columns match each row.
+ *   SQL_DELETE: Deletes the table row whose key columns match each row.
+ * table - The name of the table, as it is written in SQL.
+ * columns - An array of the names of the columns in each row, as they are written in SQL.
+ * rows - An array of rows, each an array holding a value for each column, in order.
+ *        Values are bound as by ndbcBindParameters.  The values for each column must share a type, apart from
+ *        nulls, and numbers, which widen to fit every row.
+ * keys - An array of the names of the columns identifying the table row to write, each one of columns.
+ *        Required for 'SQL_UPDATE' and 'SQL_DELETE'.
+ * batchSize - The number of rows sent to the server in each call.  Defaults to 1000.
+ *
+ * Writes the rows on a statement of its own, in batches.
+ * Inserts use SQLBulkOperations on a keyset-driven cursor if the driver supports it (SQL_CA1_BULK_ADD), sending each
+ * batch as one rowset.  Otherwise, and for updates and deletes, the rows are sent as parameter arrays of a single
+ * INSERT, UPDATE or DELETE statement matching on the key columns, as by ndbcExecBatch.
+ * Stops after the first batch that fails.
+ * Returns an array with the status of each row: 'SQL_PARAM_SUCCESS', 'SQL_PARAM_SUCCESS_WITH_INFO',
+ * 'SQL_PARAM_ERROR', 'SQL_PARAM_UNUSED' for rows that were not run, or 'SQL_PARAM_DIAG_UNAVAILABLE'.
+ * If nothing could be run, returns a string describing the error instead.  Use typeof to determine success.
+ */
+Handle<Value> ndbcBulkWrite(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLHANDLE connection = (SQLHANDLE) External::Unwrap(args[0]);
+  SQLHANDLE statement = NULL;
+  ndbcBuffer query = {NULL, 0, 0};
+  SQLUINTEGER* order = NULL;
+  Local<Array> columns;
+  Local<Array> keys = Array::New(0);
+  Local<Array> rows;
+  Local<Array> params;
+  Local<Array> row;
+  SQLUSMALLINT operation = SQL_ADD;
+  SQLUSMALLINT exists = SQL_FALSE;
+  SQLUINTEGER attributes = 0;
+  SQLUINTEGER batchSize = 1000;
+  SQLUINTEGER orderCount = 0;
+  SQLUINTEGER i;
+  SQLUINTEGER k;
+  SQLUINTEGER r;
+  bool done = false;
+  bool ok = true;
+
+  if (args[1]->ToString() == ndbcSQL_ADD) {
+    operation = SQL_ADD;
+  } else if (args[1]->ToString() == ndbcSQL_UPDATE) {
+    operation = SQL_UPDATE;
+  } else if (args[1]->ToString() == ndbcSQL_DELETE) {
+    operation = SQL_DELETE;
+  } else {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (!args[2]->IsString() || args[2]->ToString()->Length() < 1
+      || !args[3]->IsArray() || Local<Array>::Cast(args[3])->Length() < 1
+      || Local<Array>::Cast(args[3])->Length() > 32767 || !args[4]->IsArray()) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  } else {
+    columns = Local<Array>::Cast(args[3]);
+    rows = Local<Array>::Cast(args[4]);
+  }
+  if (ok && operation != SQL_ADD) {
+    if (args.Length() < 6 || !args[5]->IsArray() || Local<Array>::Cast(args[5])->Length() < 1) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    } else {
+      keys = Local<Array>::Cast(args[5]);
+    }
+  }
+  if (args.Length() >= 7 && !args[6]->IsUndefined()) {
+    batchSize = args[6]->Uint32Value();
+    if (batchSize < 1) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+  }
+
+  // Work out which column supplies each parameter of the statement: for updates, the non-key columns being set
+  // followed by the key columns, and for deletes, just the key columns.
+  if (ok && operation != SQL_ADD) {
+    order = (SQLUINTEGER*) malloc((columns->Length() + keys->Length()) * sizeof(SQLUINTEGER));
+    if (order == NULL) {
+      ok = false;
+      retVal = ndbcINTERNAL_ERROR;
+    }
+    for (i = 0; ok && operation == SQL_UPDATE && i < columns->Length(); i++) {
+      for (k = 0; k < keys->Length() && !columns->Get(i)->StrictEquals(keys->Get(k)); k++) {
+      }
+      if (k == keys->Length()) {
+        order[orderCount++] = i;
+      }
+    }
+    if (ok && operation == SQL_UPDATE && orderCount == 0) {
+      // Every column is a key, so there is nothing to set.
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    }
+    for (k = 0; ok && k < keys->Length(); k++) {
+      for (i = 0; i < columns->Length() && !columns->Get(i)->StrictEquals(keys->Get(k)); i++) {
+      }
+      if (i == columns->Length()) {
+        ok = false;
+        retVal = ndbcINVALID_ARGUMENT;
+      } else {
+        order[orderCount++] = i;
+      }
+    }
+  }
+
+  if (ok) {
+    if (operation == SQL_ADD) {
+      params = rows;
+    } else {
+      params = Array::New(rows->Length());
+      for (r = 0; ok && r < rows->Length(); r++) {
+        if (!rows->Get(r)->IsArray()) {
+          ok = false;
+          retVal = ndbcINVALID_ARGUMENT;
           break;
-        case SQL_FLOAT:
-        case SQL_DOUBLE:
-          *dataLen = 24;
-          recLen += 25;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("n"));
+        }
+        row = Array::New(orderCount);
+        for (i = 0; i < orderCount; i++) {
+          row->Set(i, Local<Array>::Cast(rows->Get(r))->Get(order[i]));
+        }
+        params->Set(r, row);
+      }
+    }
+    // Check every row up front, so neither a bulk add nor the parameter arrays stop part way on an invalid row.
+    ok = ok && ndbcCheckParamRows(params, retVal);
+  }
+
+  if (ok) {
+    switch (SQLAllocHandle(SQL_HANDLE_STMT, connection, &statement)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    default:
+      ndbcFreeStatementState(statement);
+    }
+  }
+
+  // Inserts go through a bulk add on an empty keyset of the table's columns where the driver supports it.
+  if (ok && operation == SQL_ADD
+      && SQLGetFunctions(connection, SQL_API_SQLBULKOPERATIONS, &exists) != SQL_ERROR && exists == SQL_TRUE
+      && SQLGetInfo(connection, SQL_KEYSET_CURSOR_ATTRIBUTES1, &attributes, sizeof(attributes), NULL) != SQL_ERROR
+      && (attributes & SQL_CA1_BULK_ADD) != 0) {
+    ok = ndbcBufferAppend(&query, "SELECT ", 7);
+    for (i = 0; ok && i < columns->Length(); i++) {
+      String::Utf8Value name(columns->Get(i));
+      ok = (i == 0 || ndbcBufferAppend(&query, ", ", 2)) && ndbcBufferAppend(&query, *name, name.length());
+    }
+    String::Utf8Value table(args[2]);
+    ok = ok && ndbcBufferAppend(&query, " FROM ", 6) && ndbcBufferAppend(&query, *table, table.length())
+            && ndbcBufferAppend(&query, " WHERE 1 = 0", 12);
+    if (!ok) {
+      retVal = ndbcINTERNAL_ERROR;
+    } else {
+      done = ndbcBulkAdd(statement, (SQLCHAR*) query.data, (SQLINTEGER) query.len, params, batchSize, retVal);
+      if (!done) {
+        // Put the statement back to a plain cursor for the parameter arrays.
+        SQLFreeStmt(statement, SQL_CLOSE);
+        SQLFreeStmt(statement, SQL_UNBIND);
+        SQLSetStmtAttr(statement, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+        SQLSetStmtAttr(statement, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+        SQLSetStmtAttr(statement, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_FORWARD_ONLY, 0);
+        SQLSetStmtAttr(statement, SQL_ATTR_CONCURRENCY, (SQLPOINTER) SQL_CONCUR_READ_ONLY, 0);
+        query.len = 0;
+      }
+    }
+  }
+
+  if (ok && !done) {
+    String::Utf8Value table(args[2]);
+    switch (operation) {
+    case SQL_ADD:
+      ok = ndbcBufferAppend(&query, "INSERT INTO ", 12) && ndbcBufferAppend(&query, *table, table.length())
+           && ndbcBufferAppend(&query, " (", 2);
+      for (i = 0; ok && i < columns->Length(); i++) {
+        String::Utf8Value name(columns->Get(i));
+        ok = (i == 0 || ndbcBufferAppend(&query, ", ", 2)) && ndbcBufferAppend(&query, *name, name.length());
+      }
+      ok = ok && ndbcBufferAppend(&query, ") VALUES (", 10);
+      for (i = 0; ok && i < columns->Length(); i++) {
+        ok = (i == 0) ? ndbcBufferAppend(&query, "?", 1) : ndbcBufferAppend(&query, ", ?", 3);
+      }
+      ok = ok && ndbcBufferAppend(&query, ")", 1);
+      break;
+    case SQL_UPDATE:
+      ok = ndbcBufferAppend(&query, "UPDATE ", 7) && ndbcBufferAppend(&query, *table, table.length())
+           && ndbcBufferAppend(&query, " SET ", 5);
+      for (i = 0; ok && i < orderCount - keys->Length(); i++) {
+        String::Utf8Value name(columns->Get(order[i]));
+        ok = (i == 0 || ndbcBufferAppend(&query, ", ", 2)) && ndbcBufferAppend(&query, *name, name.length())
+             && ndbcBufferAppend(&query, " = ?", 4);
+      }
+      break;
+    default:
+      ok = ndbcBufferAppend(&query, "DELETE FROM ", 12) && ndbcBufferAppend(&query, *table, table.length());
+    }
+    for (k = 0; ok && k < keys->Length(); k++) {
+      String::Utf8Value name(keys->Get(k));
+      ok = ndbcBufferAppend(&query, (k == 0) ? " WHERE " : " AND ", (k == 0) ? 7 : 5)
+           && ndbcBufferAppend(&query, *name, name.length()) && ndbcBufferAppend(&query, " = ?", 4);
+    }
+    if (!ok) {
+      retVal = ndbcINTERNAL_ERROR;
+    } else {
+      switch (SQLPrepare(statement, (SQLCHAR*) query.data, (SQLINTEGER) query.len)) {
+      case SQL_ERROR:
+        retVal = ndbcSQL_ERROR;
+        break;
+      case SQL_INVALID_HANDLE:
+        retVal = ndbcSQL_INVALID_HANDLE;
+        break;
+      default:
+        ndbcExecParamBatches(statement, params, batchSize, retVal);
+      }
+    }
+  }
+
+  if (statement != NULL) {
+    ndbcFreeStatementState(statement);
+    SQLFreeHandle(SQL_HANDLE_STMT, statement);
+  }
+  free(query.data);
+  free(order);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal type ndbcParamSpec
+ * A parameter bound from a parameter object by ndbcBindParamSpec, so its value can be read back after execution.
+ * direction - SQL_PARAM_INPUT, SQL_PARAM_OUTPUT or SQL_PARAM_INPUT_OUTPUT.  0 for a parameter bound from a plain value.
+ * kind - How the value is bound, as returned by ndbcParamKind.
+ * data - The bound value, in the statement's parameter memory.
+ * cell - The length of data in bytes.
+ * ind - The bound length / indicator, in the statement's parameter memory.
+ */
+typedef struct {
+  SQLSMALLINT direction;
+  char kind;
+  char* data;
+  SQLLEN cell;
+  SQLLEN* ind;
+} ndbcParamSpec;
+
+/* ndbc internal function ndbcIsParamSpec
+ * Returns whether a parameter value is a parameter object, rather than a value bound as by ndbcBindParameters.
+ */
+bool ndbcIsParamSpec(Local<Value> value) {
+  return value->IsObject() && !value->IsArray() && !value->IsDate() && !node::Buffer::HasInstance(value);
+}
+
+/* ndbc internal function ndbcBindParamSpec
+ * Binds parameter <number> of a statement from a parameter object, as described for ndbcCallProcedure.
+ * The value is kept in the statement's parameter memory, arena, and described in spec so it can be read back.
+ * Returns false and sets retVal to the error string if the object is invalid or binding fails.
+ */
+bool ndbcBindParamSpec(SQLHANDLE statement, SQLUSMALLINT number, Local<Object> object, ndbcArena* arena,
+                       ndbcParamSpec* spec, Local<Value>& retVal) {
+  Local<Value> direction = object->Get(String::NewSymbol("direction"));
+  Local<Value> type = object->Get(String::NewSymbol("type"));
+  Local<Value> value = object->Get(String::NewSymbol("value"));
+  SQLSMALLINT cType;
+  SQLSMALLINT sqlType;
+  SQLSMALLINT digits = 0;
+  SQLULEN size;
+  size_t len = 0;
+
+  if (direction->IsUndefined() || direction->ToString() == ndbcSQL_PARAM_INPUT) {
+    spec->direction = SQL_PARAM_INPUT;
+  } else if (direction->ToString() == ndbcSQL_PARAM_OUTPUT) {
+    spec->direction = SQL_PARAM_OUTPUT;
+    value = Local<Value>::New(Null());
+  } else if (direction->ToString() == ndbcSQL_PARAM_INPUT_OUTPUT) {
+    spec->direction = SQL_PARAM_INPUT_OUTPUT;
+  } else {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+
+  // Take the kind from the type if given, or from the value, defaulting to text for an untyped output.
+  if (type->IsUndefined()) {
+    spec->kind = ndbcParamKind(value);
+    sqlType = 0;
+  } else if (type->ToString() == ndbcSQL_BIT) {
+    spec->kind = 'b';
+    sqlType = SQL_BIT;
+  } else if (type->ToString() == ndbcSQL_TINYINT) {
+    spec->kind = 'i';
+    sqlType = SQL_TINYINT;
+  } else if (type->ToString() == ndbcSQL_SMALLINT) {
+    spec->kind = 'i';
+    sqlType = SQL_SMALLINT;
+  } else if (type->ToString() == ndbcSQL_INTEGER) {
+    spec->kind = 'i';
+    sqlType = SQL_INTEGER;
+  } else if (type->ToString() == ndbcSQL_BIGINT) {
+    spec->kind = 'l';
+    sqlType = SQL_BIGINT;
+  } else if (type->ToString() == ndbcSQL_REAL) {
+    spec->kind = 'd';
+    sqlType = SQL_REAL;
+  } else if (type->ToString() == ndbcSQL_FLOAT) {
+    spec->kind = 'd';
+    sqlType = SQL_FLOAT;
+  } else if (type->ToString() == ndbcSQL_DOUBLE) {
+    spec->kind = 'd';
+    sqlType = SQL_DOUBLE;
+  } else if (type->ToString() == ndbcSQL_DECIMAL) {
+    spec->kind = 'q';
+    sqlType = SQL_DECIMAL;
+  } else if (type->ToString() == ndbcSQL_NUMERIC) {
+    spec->kind = 'q';
+    sqlType = SQL_NUMERIC;
+  } else if (type->ToString() == ndbcSQL_CHAR) {
+    spec->kind = 'q';
+    sqlType = SQL_CHAR;
+  } else if (type->ToString() == ndbcSQL_VARCHAR) {
+    spec->kind = 'q';
+    sqlType = SQL_VARCHAR;
+  } else if (type->ToString() == ndbcSQL_LONGVARCHAR) {
+    spec->kind = 'q';
+    sqlType = SQL_LONGVARCHAR;
+  } else if (type->ToString() == ndbcSQL_WVARCHAR) {
+    spec->kind = 'q';
+    sqlType = SQL_WVARCHAR;
+  } else if (type->ToString() == ndbcSQL_BINARY) {
+    spec->kind = 'x';
+    sqlType = SQL_BINARY;
+  } else if (type->ToString() == ndbcSQL_VARBINARY) {
+    spec->kind = 'x';
+    sqlType = SQL_VARBINARY;
+  } else if (type->ToString() == ndbcSQL_LONGVARBINARY) {
+    spec->kind = 'x';
+    sqlType = SQL_LONGVARBINARY;
+  } else if (type->ToString() == ndbcSQL_TYPE_TIMESTAMP) {
+    spec->kind = 't';
+    sqlType = SQL_TYPE_TIMESTAMP;
+  } else {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  if (spec->kind == 'n') {
+    spec->kind = 'q';
+  } else if (spec->kind == 0) {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  // The value must suit the kind, apart from text, which any value converts to.
+  if (!value->IsNull() && !value->IsUndefined() && spec->kind != 'q'
+      && ndbcWidenParamKind(spec->kind, ndbcParamKind(value)) != spec->kind) {
+    retVal = ndbcINVALID_ARGUMENT;
+    return false;
+  }
+  if (!value->IsNull() && !value->IsUndefined()) {
+    if (spec->kind == 'q') {
+      len = value->ToString()->Utf8Length();
+    } else if (spec->kind == 'x') {
+      len = node::Buffer::Length(value->ToObject());
+    }
+  }
+
+  // Size text and binary values to hold the larger of the input value and the size given, 8000 bytes by default.
+  switch (spec->kind) {
+  case 'b':
+    cType = SQL_C_BIT;
+    size = 1;
+    spec->cell = sizeof(SQLCHAR);
+    break;
+  case 'i':
+    cType = SQL_C_SLONG;
+    size = 10;
+    spec->cell = sizeof(SQLINTEGER);
+    break;
+  case 'l':
+    cType = SQL_C_SBIGINT;
+    size = 19;
+    spec->cell = sizeof(SQLBIGINT);
+    break;
+  case 'd':
+    cType = SQL_C_DOUBLE;
+    size = 15;
+    spec->cell = sizeof(double);
+    break;
+  case 't':
+    cType = SQL_C_TYPE_TIMESTAMP;
+    size = 23;
+    digits = 3;
+    spec->cell = sizeof(SQL_TIMESTAMP_STRUCT);
+    break;
+  default:
+    cType = (spec->kind == 'x') ? SQL_C_BINARY : SQL_C_CHAR;
+    if (sqlType == SQL_DECIMAL || sqlType == SQL_NUMERIC) {
+      // Decimals are exchanged as text, so no digits are lost: room for a sign and a decimal point.
+      size = object->Get(String::NewSymbol("size"))->IsUndefined() ? 38 : object->Get(String::NewSymbol("size"))->Uint32Value();
+      digits = (SQLSMALLINT) object->Get(String::NewSymbol("digits"))->Int32Value();
+      spec->cell = (SQLLEN) size + 3;
+    } else {
+      size = object->Get(String::NewSymbol("size"))->IsUndefined() ? 8000 : object->Get(String::NewSymbol("size"))->Uint32Value();
+      if (size < len) {
+        size = len;
+      }
+      if (size < 1) {
+        size = 1;
+      }
+      spec->cell = (SQLLEN) size + ((spec->kind == 'q') ? 1 : 0);
+      if (sqlType == 0) {
+        sqlType = (spec->kind == 'x') ? ((size > 8000) ? SQL_LONGVARBINARY : SQL_VARBINARY)
+                                      : ((size > 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR);
+      }
+    }
+    if ((size_t) spec->cell > ndbcMaxLength / 2 || (SQLLEN) len >= spec->cell + ((spec->kind == 'x') ? 1 : 0)) {
+      retVal = ndbcINVALID_ARGUMENT;
+      return false;
+    }
+  }
+  if (sqlType == 0) {
+    switch (spec->kind) {
+    case 'b':
+      sqlType = SQL_BIT;
+      break;
+    case 'i':
+      sqlType = SQL_INTEGER;
+      break;
+    case 'l':
+      sqlType = SQL_BIGINT;
+      break;
+    case 'd':
+      sqlType = SQL_DOUBLE;
+      break;
+    default:
+      sqlType = SQL_TYPE_TIMESTAMP;
+    }
+  }
+
+  spec->data = ndbcArenaAlloc(arena, (size_t) spec->cell);
+  spec->ind = (SQLLEN*) ndbcArenaAlloc(arena, sizeof(SQLLEN));
+  if (spec->data == NULL || spec->ind == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    return false;
+  }
+  memset(spec->data, 0, (size_t) spec->cell);
+
+  // Copy in the value sent to the server.  The driver sets the indicator again for the value returned.
+  *spec->ind = (SQLLEN) spec->cell;
+  if (value->IsNull() || value->IsUndefined()) {
+    *spec->ind = SQL_NULL_DATA;
+  } else {
+    switch (spec->kind) {
+    case 'b':
+      *(SQLCHAR*) spec->data = value->BooleanValue() ? 1 : 0;
+      break;
+    case 'i':
+      *(SQLINTEGER*) spec->data = value->Int32Value();
+      break;
+    case 'l':
+      *(SQLBIGINT*) spec->data = (SQLBIGINT) value->NumberValue();
+      break;
+    case 'd':
+      *(double*) spec->data = value->NumberValue();
+      break;
+    case 'q':
+      *spec->ind = value->ToString()->WriteUtf8(spec->data, (int) len, NULL, String::NO_NULL_TERMINATION);
+      break;
+    case 'x':
+      *spec->ind = (SQLLEN) len;
+      memcpy(spec->data, node::Buffer::Data(value->ToObject()), len);
+      break;
+    case 't':
+      ndbcEpochTimestamp(value->NumberValue(), (SQL_TIMESTAMP_STRUCT*) spec->data);
+    }
+  }
+
+  switch (SQLBindParameter(statement, number, spec->direction, cType, sqlType, size, digits, (SQLPOINTER) spec->data,
+                           spec->cell, spec->ind)) {
+  case SQL_ERROR:
+    retVal = ndbcSQL_ERROR;
+    return false;
+  case SQL_INVALID_HANDLE:
+    retVal = ndbcSQL_INVALID_HANDLE;
+    return false;
+  }
+  return true;
+}
+
+/* ndbc internal function ndbcParamSpecValue
+ * Returns the javascript value of a parameter bound by ndbcBindParamSpec, as returned by the server.
+ * Big integers are returned as strings, since a Number can not hold every 64 bit value.
+ * Text and binary values the server truncated to fit are returned truncated.
+ */
+Local<Value> ndbcParamSpecValue(ndbcParamSpec* spec) {
+  char text[34];
+  char digit[20];
+  SQLINTEGER digits = 0;
+  SQLINTEGER k = 0;
+  SQLBIGINT value;
+  SQLUBIGINT magnitude;
+  SQLLEN len = *spec->ind;
+
+  if (len == SQL_NULL_DATA) {
+    return Local<Value>::New(Null());
+  }
+  switch (spec->kind) {
+  case 'b':
+    return Local<Value>::New(Boolean::New(*(SQLCHAR*) spec->data != 0));
+  case 'i':
+    return Integer::New(*(SQLINTEGER*) spec->data);
+  case 'l':
+    value = *(SQLBIGINT*) spec->data;
+    if (value < 0) {
+      text[k] = '-';
+      k++;
+      magnitude = 0 - (SQLUBIGINT) value;
+    } else {
+      magnitude = (SQLUBIGINT) value;
+    }
+    do {
+      digit[digits] = (char) ('0' + magnitude % 10);
+      digits++;
+      magnitude /= 10;
+    } while (magnitude > 0);
+    while (digits > 0) {
+      digits--;
+      text[k] = digit[digits];
+      k++;
+    }
+    return String::New(text, k);
+  case 'd':
+    return Number::New(*(double*) spec->data);
+  case 'q':
+    // Leave out the null terminator, and find the length if the driver could not report it.
+    if (len < 0 || len > spec->cell - 1) {
+      len = (SQLLEN) strlen(spec->data);
+    }
+    return String::New(spec->data, (int) len);
+  case 'x':
+    if (len < 0 || len > spec->cell) {
+      len = spec->cell;
+    }
+    return Local<Value>::New(node::Buffer::New(spec->data, (size_t) len)->handle_);
+  default:
+    // Read the timestamp back as epoch milliseconds, as it was written.
+    text[ndbcWriteDateTime(text, (SQLCHAR*) spec->data, 3, 'E')] = 0;
+    return Date::New(strtod(text, NULL));
+  }
+}
+
+/* ndbc internal function ndbcJsonResultSet
+ * Reads the whole of a statement's current result set, with a row descriptor built with options as for
+ * ndbcJsonDescribe.
+ * Returns true and sets retVal to the result set as ndbcJsonHeader, ndbcJsonData and ndbcJsonTrailer would output it
+ * together: a Json-formatted array of the column names followed by each row.
+ * Returns false and sets retVal to the error string if the result set can not be described or fetched.
+ */
+bool ndbcJsonResultSet(SQLHANDLE statement, Handle<Value> options, Local<Value>& retVal) {
+  ndbcResultMeta* meta;
+  ndbcRowDesc* desc;
+  ndbcColumnMeta* column;
+  ndbcRowBuffer rowBuf;
+  ndbcArena arena = { NULL, NULL, 0 };
+  Local<Value> descriptor;
+  SQLSMALLINT i;
+  size_t k;
+  char* recData;
+  bool ok;
+  bool data = true;
+
+  rowBuf.statement = NULL;
+  rowBuf.parsed = NULL;
+  if (!ndbcDescribeRows(statement, options, descriptor) || ndbcDescribeResult(statement, &meta) == SQL_ERROR) {
+    retVal = descriptor;
+    return false;
+  }
+  desc = ndbcUnwrapRowDesc(descriptor);
+
+  // Write the header, sized exactly as by ndbcJsonHeader.
+  k = 3;
+  for (i = 0; i < desc->columns; i++) {
+    column = &meta->column[desc->column[i] - 1];
+    k += ndbcWriteJsonString(NULL, column->name, column->nameLen) + 1;
+  }
+  recData = ndbcArenaReserve(&arena, k);
+  ok = (recData != NULL);
+  if (ok) {
+    k = 0;
+    recData[k++] = '[';
+    recData[k++] = '[';
+    for (i = 0; i < desc->columns; i++) {
+      if (i > 0) {
+        recData[k++] = ',';
+      }
+      column = &meta->column[desc->column[i] - 1];
+      k += ndbcWriteJsonString(recData + k, column->name, column->nameLen);
+    }
+    recData[k++] = ']';
+    ndbcArenaCommit(&arena, k);
+  } else {
+    retVal = ndbcINTERNAL_ERROR;
+  }
+
+  // Append every row, then close the array.
+  ok = ok && ndbcBindRowDesc(statement, descriptor, &rowBuf, retVal);
+  while (ok && data) {
+    switch (ndbcFetch(statement, &rowBuf)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    case SQL_NO_DATA:
+      data = false;
+      break;
+    default:
+      recData = ndbcArenaReserve(&arena, rowBuf.recLen);
+      if (recData == NULL) {
+        retVal = ndbcINTERNAL_ERROR;
+        ok = false;
+        break;
+      }
+      ndbcArenaCommit(&arena, ndbcWriteRow(recData, &rowBuf));
+    }
+  }
+  if (ok) {
+    recData = ndbcArenaReserve(&arena, 1);
+    if (recData == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    } else {
+      recData[0] = ']';
+      ndbcArenaCommit(&arena, 1);
+      ok = ndbcArenaToString(&arena, retVal);
+    }
+  }
+  ndbcFreeRowBuffer(&rowBuf);
+  ndbcFreeArena(&arena);
+  return ok;
+}
+
+/* ndbc custom function ndbcCallProcedure
+ * ndbcCallProcedure(statement, query, [params], [options])
+ * statement - An statement handle created with SQLAllocHandle.
+ * query - The procedure call, in ODBC's call escape syntax, eg. '{call proc(?, ?)}', or '{? = call func(?)}' for a
+ *         procedure with a return value.
+ * params - An array holding a value for each parameter marker ('?') of the query, in order.  Defaults to none.
+ *          Plain values are input parameters, bound as by ndbcBindParameters.  Any other parameter is given as an
+ *          object with these properties:
+ *   direction: 'SQL_PARAM_INPUT' (default), 'SQL_PARAM_OUTPUT' or 'SQL_PARAM_INPUT_OUTPUT'.
+ *   type: The parameter's SQL type: 'SQL_BIT', 'SQL_TINYINT', 'SQL_SMALLINT', 'SQL_INTEGER', 'SQL_BIGINT', 'SQL_REAL',
+ *         'SQL_FLOAT', 'SQL_DOUBLE', 'SQL_DECIMAL', 'SQL_NUMERIC', 'SQL_CHAR', 'SQL_VARCHAR', 'SQL_LONGVARCHAR',
+ *         'SQL_WVARCHAR', 'SQL_BINARY', 'SQL_VARBINARY', 'SQL_LONGVARBINARY' or 'SQL_TYPE_TIMESTAMP'.
+ *         Defaults to the type ndbcBindParameters gives the value, or 'SQL_VARCHAR' for an output parameter without one.
+ *   value: The value sent for input and input / output parameters.
+ *   size: The largest value returned for text and binary types, in bytes, or the precision of decimals.
+ *         Defaults to 8000, or the length of the value sent if longer, and to 38 for decimals.
+ *   digits: The scale of decimals.  Defaults to 0.
+ * options - The options for describing result sets, as for ndbcJsonDescribe.
+ *
+ * Runs the procedure and reads everything it returns in one call: every result set, followed by the output
+ * parameters, which drivers only return once the result sets have been read.
+ * Returns an object:
+ *   results - An array holding each result set, as ndbcJsonHeader, ndbcJsonData and ndbcJsonTrailer output it
+ *             together.  Results without columns, such as row counts, are skipped.
+ *   outputs - An array holding the returned value of each output and input / output parameter, in its position, and
+ *             null for input parameters.  Decimals and 'SQL_BIGINT' values are returned as strings, so no digits are
+ *             lost, and timestamps as Dates.
+ * If the procedure fails, returns a string describing the error instead.  Use typeof to determine success.
+ */
+Handle<Value> ndbcCallProcedure(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLHANDLE statement = (SQLHANDLE) External::Unwrap(args[0]);
+  ndbcStatementState* state;
+  ndbcParamSpec* specs = NULL;
+  Local<Array> params = Array::New(0);
+  Local<Array> values;
+  Local<Array> results = Array::New();
+  Local<Array> outputs;
+  Local<Object> result;
+  Local<Value> options;
+  Local<Value> resultSet;
+  SQLSMALLINT columns;
+  SQLUINTEGER i;
+  bool more = true;
+  bool ok = true;
+
+  if (!args[1]->IsString()) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (args.Length() >= 3 && !args[2]->IsUndefined()) {
+    if (!args[2]->IsArray() || Local<Array>::Cast(args[2])->Length() > 32767) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    } else {
+      params = Local<Array>::Cast(args[2]);
+    }
+  }
+  if (args.Length() >= 4) {
+    options = args[3];
+  }
+
+  // Bind the plain values as BindParameters would, holding each parameter object's place with a null, then bind the
+  // parameter objects over them.
+  if (ok) {
+    specs = (ndbcParamSpec*) calloc(params->Length() + 1, sizeof(ndbcParamSpec));
+    if (specs == NULL) {
+      ok = false;
+      retVal = ndbcINTERNAL_ERROR;
+    }
+  }
+  if (ok) {
+    values = Array::New(params->Length());
+    for (i = 0; i < params->Length(); i++) {
+      values->Set(i, ndbcIsParamSpec(params->Get(i)) ? Local<Value>::New(Null()) : params->Get(i));
+    }
+    ok = ndbcBindParamValues(statement, values, retVal);
+  }
+  if (ok) {
+    state = ndbcGetStatementState(statement, false);
+    for (i = 0; ok && i < params->Length(); i++) {
+      if (ndbcIsParamSpec(params->Get(i))) {
+        ok = ndbcBindParamSpec(statement, (SQLUSMALLINT) (i + 1), params->Get(i)->ToObject(), &state->params,
+                               &specs[i], retVal);
+      }
+    }
+  }
+
+  if (ok) {
+    String::Utf8Value query(args[1]);
+    ndbcResetStatementState(statement);
+    switch (SQLExecDirect(statement, (SQLCHAR*) *query, SQL_NTS)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_NEED_DATA:
+      retVal = ndbcSQL_NEED_DATA;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    }
+  }
+
+  // Read each result set in turn.  The output parameters are set once SQLMoreResults reports there are no more.
+  while (ok && more) {
+    if (SQLNumResultCols(statement, &columns) == SQL_ERROR) {
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      break;
+    }
+    if (columns > 0) {
+      ok = ndbcJsonResultSet(statement, options, resultSet);
+      if (!ok) {
+        retVal = resultSet;
+        break;
+      }
+      results->Set(results->Length(), resultSet);
+    }
+    ndbcResetStatementState(statement);
+    switch (SQLMoreResults(statement)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      ok = false;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      ok = false;
+      break;
+    case SQL_STILL_EXECUTING:
+      retVal = ndbcSQL_STILL_EXECUTING;
+      ok = false;
+      break;
+    case SQL_NO_DATA:
+    case SQL_PARAM_DATA_AVAILABLE:
+      more = false;
+    }
+  }
+
+  if (ok) {
+    outputs = Array::New(params->Length());
+    for (i = 0; i < params->Length(); i++) {
+      if (specs[i].direction == SQL_PARAM_OUTPUT || specs[i].direction == SQL_PARAM_INPUT_OUTPUT) {
+        outputs->Set(i, ndbcParamSpecValue(&specs[i]));
+      } else {
+        outputs->Set(i, Null());
+      }
+    }
+    result = Object::New();
+    result->Set(String::NewSymbol("results"), results);
+    result->Set(String::NewSymbol("outputs"), outputs);
+    retVal = result;
+  }
+  free(specs);
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcStatementCache
+ * ndbcStatementCache(connection, [capacity])
+ * connection - A connection handle created with SQLAllocHandle.
+ * capacity - The number of prepared statements ndbcCachedExecute keeps for the connection.  Initially 64.
+ *            Must be at least 1, since ndbcCachedExecute returns the statement it ran from the cache.
+ *            Lowering it frees the least recently used statements over the new capacity.
+ *            If omitted, the capacity is left unchanged.
+ *
+ * Returns the connection's statement cache settings and counters as an object:
+ *   capacity - The number of prepared statements kept.
+ *   size - The number of prepared statements currently cached.
+ *   hits - The number of executions that reused a cached statement.
+ *   misses - The number of executions that had to prepare a new statement.
+ *   evictions - The number of cached statements freed to make room for others.
+ * Returns 'INVALID_ARGUMENT' if the capacity is 0.
+ */
+Handle<Value> ndbcStatementCache(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcConnectionState* state;
+  Local<Object> stats;
+
+  state = ndbcGetConnectionState((SQLHANDLE) External::Unwrap(args[0]), true);
+  if (state == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+  } else if (args.Length() >= 2 && !args[1]->IsUndefined() && args[1]->Uint32Value() == 0) {
+    retVal = ndbcINVALID_ARGUMENT;
+  } else {
+    if (args.Length() >= 2 && !args[1]->IsUndefined()) {
+      state->capacity = args[1]->Uint32Value();
+      while (state->count > state->capacity) {
+        ndbcDropCachedStatement(state, state->tail, true);
+        state->evictions++;
+      }
+    }
+    stats = Object::New();
+    stats->Set(String::NewSymbol("capacity"), Integer::NewFromUnsigned(state->capacity));
+    stats->Set(String::NewSymbol("size"), Integer::NewFromUnsigned(state->count));
+    stats->Set(String::NewSymbol("hits"), Number::New(state->hits));
+    stats->Set(String::NewSymbol("misses"), Number::New(state->misses));
+    stats->Set(String::NewSymbol("evictions"), Number::New(state->evictions));
+    retVal = stats;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcCachedExecute
+ * ndbcCachedExecute(connection, query, [params])
+ * connection - A connection handle connected with SQLConnect.
+ * query - The query text to execute on the server.
+ * params - An array holding a value for each parameter marker ('?') of the query, bound as by ndbcBindParameters.
+ *          Defaults to no parameters.
+ *
+ * Executes a query on a statement prepared for the same query text by an earlier call on the connection, so the
+ * server skips parsing and planning it again.  Query text seen for the first time is prepared on a new statement
+ * handle, which is kept in the connection's statement cache (see ndbcStatementCache).  When the cache is full, the
+ * least recently executed statement is freed to make room.
+ * Returns the statement handle the query ran on, to read results from with the other functions.
+ * The handle belongs to the cache: do not free it with SQLFreeHandle, and finish with its results before the
+ * same query is executed again or the statement could be freed to make room.
+ * If the execution needs data at execution time or is still running asynchronously, returns an object instead:
+ *   statement - The statement handle, to finish the execution on with SQLParamData or SQLExecute.
+ *   status - 'SQL_NEED_DATA' or 'SQL_STILL_EXECUTING'.
+ * If the query fails, returns a string describing the error.  Use typeof to determine success.
+ */
+Handle<Value> ndbcCachedExecute(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcConnectionState* state;
+  ndbcCachedStatement* entry = NULL;
+  SQLHANDLE statement = NULL;
+  SQLUINTEGER hash;
+  SQLINTEGER queryLen;
+  Local<Object> pending;
+  bool ok = true;
+
+  String::AsciiValue rawVal(args[1]->ToString());
+  queryLen = rawVal.length();
+  hash = ndbcHash(*rawVal, queryLen);
+  state = ndbcGetConnectionState((SQLHANDLE) External::Unwrap(args[0]), true);
+  if (state == NULL) {
+    retVal = ndbcINTERNAL_ERROR;
+    ok = false;
+  }
+
+  if (ok) {
+    // Look the query text up in the cache.
+    for (entry = state->buckets[hash & 255]; entry != NULL; entry = entry->chain) {
+      if (entry->hash == hash && entry->queryLen == queryLen && memcmp(entry->query, *rawVal, queryLen) == 0) {
+        break;
+      }
+    }
+    if (entry != NULL) {
+      // Close any cursor left open by the previous execution, and move the entry to the front of the list.
+      state->hits++;
+      statement = entry->statement;
+      SQLFreeStmt(statement, SQL_CLOSE);
+      if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+        if (entry->next != NULL) {
+          entry->next->prev = entry->prev;
+        } else {
+          state->tail = entry->prev;
+        }
+        entry->prev = NULL;
+        entry->next = state->head;
+        state->head->prev = entry;
+        state->head = entry;
+      }
+    } else {
+      state->misses++;
+      entry = (ndbcCachedStatement*) malloc(sizeof(ndbcCachedStatement) + queryLen);
+      if (entry == NULL) {
+        retVal = ndbcINTERNAL_ERROR;
+        ok = false;
+      }
+      // Prepare the query on a new statement handle.
+      if (ok) {
+        switch (SQLAllocHandle(SQL_HANDLE_STMT, (SQLHANDLE) External::Unwrap(args[0]), &statement)) {
+        case SQL_ERROR:
+          retVal = ndbcSQL_ERROR;
+          ok = false;
           break;
-        case SQL_CHAR:
-        case SQL_VARCHAR:
-        case SQL_LONGVARCHAR:
-        case SQL_WCHAR:
-        case SQL_WVARCHAR:
-        case SQL_WLONGVARCHAR:
-          // Double length for escape sequences, add 3 for quotes and a comma.
-          recLen += (*dataLen * 2) + 3;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("q"));
+        case SQL_INVALID_HANDLE:
+          retVal = ndbcSQL_INVALID_HANDLE;
+          ok = false;
           break;
-        case SQL_TYPE_DATE:
-        case SQL_TYPE_TIME:
-        case SQL_TYPE_TIMESTAMP:
-        case SQL_INTERVAL_MONTH:
-        case SQL_INTERVAL_YEAR:
-        case SQL_INTERVAL_YEAR_TO_MONTH:
-        case SQL_INTERVAL_DAY:
-        case SQL_INTERVAL_HOUR:
-        case SQL_INTERVAL_MINUTE:
-        case SQL_INTERVAL_SECOND:
-        case SQL_INTERVAL_DAY_TO_HOUR:
-        case SQL_INTERVAL_DAY_TO_MINUTE:
-        case SQL_INTERVAL_DAY_TO_SECOND:
-        case SQL_INTERVAL_HOUR_TO_MINUTE:
-        case SQL_INTERVAL_HOUR_TO_SECOND:
-        case SQL_INTERVAL_MINUTE_TO_SECOND:
-        case SQL_GUID:
-          // Add 1 to data length to fix date length bug
-          *dataLen += 1;
-          // Add 3 for quotes and a comma
-          recLen += *dataLen + 3;
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("q"));
+        default:
+          // A new statement may reuse the address of a freed one, so never inherit its state.
+          ndbcFreeStatementState(statement);
+          switch (SQLPrepare(statement, (SQLCHAR*) *rawVal, queryLen)) {
+          case SQL_ERROR:
+            retVal = ndbcSQL_ERROR;
+            ok = false;
+            break;
+          case SQL_INVALID_HANDLE:
+            retVal = ndbcSQL_INVALID_HANDLE;
+            ok = false;
+            break;
+          case SQL_STILL_EXECUTING:
+            retVal = ndbcSQL_STILL_EXECUTING;
+            ok = false;
+          }
+          if (!ok) {
+            SQLFreeHandle(SQL_HANDLE_STMT, statement);
+          }
+        }
+      }
+      if (ok) {
+        // Make room only once the query is prepared, so a failed prepare never costs a cached statement, and the
+        // statement being added is never the one freed.
+        while (state->count > 0 && state->count >= state->capacity) {
+          ndbcDropCachedStatement(state, state->tail, true);
+          state->evictions++;
+        }
+        // Add the entry to the front of the list and to its hash bucket.
+        entry->statement = statement;
+        entry->hash = hash;
+        entry->queryLen = queryLen;
+        memcpy(entry->query, *rawVal, queryLen);
+        entry->query[queryLen] = 0;
+        entry->prev = NULL;
+        entry->next = state->head;
+        if (state->head != NULL) {
+          state->head->prev = entry;
+        } else {
+          state->tail = entry;
+        }
+        state->head = entry;
+        entry->chain = state->buckets[hash & 255];
+        state->buckets[hash & 255] = entry;
+        state->count++;
+      } else {
+        free(entry);
+        entry = NULL;
+      }
+    }
+  }
+
+  if (ok) {
+    // Bind this execution's parameters, replacing those of the previous one.
+    if (args.Length() >= 3) {
+      ok = ndbcBindParamValues(statement, args[2], retVal);
+    } else {
+      ok = ndbcBindParamValues(statement, Array::New(0), retVal);
+    }
+  }
+
+  if (ok) {
+    ndbcResetStatementState(statement);
+    switch (SQLExecute(statement)) {
+    case SQL_ERROR:
+      retVal = ndbcSQL_ERROR;
+      break;
+    case SQL_INVALID_HANDLE:
+      retVal = ndbcSQL_INVALID_HANDLE;
+      break;
+    case SQL_NEED_DATA:
+      pending = Object::New();
+      pending->Set(String::NewSymbol("statement"), External::Wrap(statement));
+      pending->Set(String::NewSymbol("status"), ndbcSQL_NEED_DATA);
+      retVal = pending;
+      break;
+    case SQL_STILL_EXECUTING:
+      pending = Object::New();
+      pending->Set(String::NewSymbol("statement"), External::Wrap(statement));
+      pending->Set(String::NewSymbol("status"), ndbcSQL_STILL_EXECUTING);
+      retVal = pending;
+      break;
+    default:
+      retVal = External::Wrap(statement);
+    }
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc internal type ndbcLoadJob
+ * A bulk load run by ndbcBulkLoad on a worker thread.
+ * The worker never touches javascript values, so everything it needs is copied into the job before it is queued.
+ * request - The libuv work request.  Its data points back at the job.
+ * callback - The javascript function called with the outcome.
+ * connection - The connection handle the load runs on.
+ * query - The insert query, null terminated.
+ * file - The path of the file to load, null terminated.
+ * columns - For NDJSON, the member names that supply each parameter, in order.  NULL for CSV.
+ * columnLen - The length of each member name.
+ * columnCount - The number of member names.
+ * ndjson - True to read NDJSON, false to read CSV.
+ * header - True if the first CSV record holds column names and is skipped.
+ * delimiter - The CSV field separator.
+ * batchSize - The number of rows sent to the server in each execution.
+ * commitInterval - The number of rows between commits, or 0 to leave transactions to the connection.
+ * error - The error that stopped the load, or NULL.
+ * records - The number of records read, not counting a CSV header.
+ * loaded - The number of records inserted, less any rolled back.
+ * failed - The number of records that could not be parsed or were rejected by the server.
+ * errorCount - The number of entries in errors.
+ * errors - The index of each of the first ndbcLoadMaxErrors failed records.
+ */
+#define ndbcLoadMaxErrors 1000
+typedef struct {
+  uv_work_t request;
+  Persistent<Function> callback;
+  SQLHANDLE connection;
+  char* query;
+  char* file;
+  char** columns;
+  size_t* columnLen;
+  SQLSMALLINT columnCount;
+  bool ndjson;
+  bool header;
+  char delimiter;
+  SQLUINTEGER batchSize;
+  SQLUINTEGER commitInterval;
+  const char* error;
+  double records;
+  double loaded;
+  double failed;
+  SQLUINTEGER errorCount;
+  double errors[ndbcLoadMaxErrors];
+} ndbcLoadJob;
+
+/* ndbc internal type ndbcLoadReader
+ * Buffered input for a bulk load.
+ * file - The file being read.
+ * pos - The position of the next byte in data.
+ * len - The number of bytes in data.
+ * data - The block of the file read last.
+ */
+typedef struct {
+  FILE* file;
+  size_t pos;
+  size_t len;
+  char data[65536];
+} ndbcLoadReader;
+
+/* ndbc internal function ndbcLoadGetc
+ * Returns the next byte of a bulk load file, or -1 at the end of the file.
+ */
+int ndbcLoadGetc(ndbcLoadReader* reader) {
+  if (reader->pos == reader->len) {
+    reader->len = fread(reader->data, 1, sizeof(reader->data), reader->file);
+    reader->pos = 0;
+    if (reader->len == 0) {
+      return -1;
+    }
+  }
+  return (unsigned char) reader->data[reader->pos++];
+}
+
+/* ndbc internal function ndbcLoadPutc
+ * Appends one byte to buf.
+ * Returns false if memory could not be allocated.
+ */
+bool ndbcLoadPutc(ndbcBuffer* buf, int c) {
+  if (buf->len == buf->size && !ndbcBufferReserve(buf, 1)) {
+    return false;
+  }
+  buf->data[buf->len++] = (char) c;
+  return true;
+}
+
+/* ndbc internal function ndbcLoadCsvRecord
+ * Reads the next record of a CSV file, appending its fields to text.
+ * Fields follow RFC 4180: they are separated by the job's delimiter, records end with LF or CRLF, and fields in double
+ * quotes may hold delimiters, line breaks and doubled quotes.  An empty unquoted field is null, while "" is an empty
+ * string.  Blank lines are skipped, unless there is only one field, when they hold a null.
+ * start and len receive the position within text and length, or SQL_NULL_DATA, of each of the job's fields.
+ * Returns 1 for a record, 0 at the end of the file, -1 for a record without exactly fieldCount fields (whose text is
+ * discarded), or -2 if memory could not be allocated.
+ */
+int ndbcLoadCsvRecord(ndbcLoadJob* job, ndbcLoadReader* reader, SQLSMALLINT fieldCount, ndbcBuffer* text,
+                      size_t* start, SQLLEN* len) {
+  size_t recordStart = text->len;
+  size_t fieldStart;
+  SQLSMALLINT f = 0;
+  bool quoted;
+  int c;
+
+  c = ndbcLoadGetc(reader);
+  for (;;) {
+    if (f == 0 && c == -1) {
+      return 0;
+    }
+    fieldStart = text->len;
+    quoted = false;
+    if (c == '\"') {
+      quoted = true;
+      for (;;) {
+        c = ndbcLoadGetc(reader);
+        if (c == '\"') {
+          c = ndbcLoadGetc(reader);
+          if (c != '\"') {
+            break;
+          }
+        } else if (c == -1) {
           break;
-        case SQL_BINARY:
-        case SQL_VARBINARY:
-        case SQL_LONGVARBINARY:
-        case SQL_UNKNOWN_TYPE:
-        default:
-          // Multiply length by 4/3 for base64 encoding, add 3 for quotes and a comma.
-          recLen += ((*dataLen / 3) * 4) + 3;
-          // Remaindered source data will add another 4 bytes to the base64 encoded length.
-          if (*dataLen % 3 != 0) {
-            recLen += 4;
+        }
+        if (!ndbcLoadPutc(text, c)) {
+          return -2;
+        }
+      }
+    }
+    // Anything after a closing quote is kept as part of the field.
+    while (c != -1 && c != job->delimiter && c != '\n') {
+      if (!ndbcLoadPutc(text, c)) {
+        return -2;
+      }
+      c = ndbcLoadGetc(reader);
+    }
+    if (c == '\n' && text->len > fieldStart && text->data[text->len - 1] == '\r') {
+      text->len--;
+    }
+    if (fieldCount > 1 && f == 0 && c != job->delimiter && !quoted && text->len == fieldStart) {
+      // A blank line.
+      if (c == -1) {
+        return 0;
+      }
+      c = ndbcLoadGetc(reader);
+      continue;
+    }
+    if (f < fieldCount) {
+      start[f] = fieldStart;
+      len[f] = (!quoted && text->len == fieldStart) ? SQL_NULL_DATA : (SQLLEN) (text->len - fieldStart);
+    }
+    f++;
+    if (c != job->delimiter) {
+      break;
+    }
+    c = ndbcLoadGetc(reader);
+  }
+  if (f != fieldCount) {
+    text->len = recordStart;
+    return -1;
+  }
+  return 1;
+}
+
+/* ndbc internal function ndbcLoadJsonString
+ * Decodes the JSON string starting after the opening quote at *p, appending it to text as UTF-8.
+ * The decoded string is never longer than its JSON form, so text must already have room for end - *p more bytes.
+ * Leaves *p after the closing quote.  Returns false if the string is malformed.
+ */
+bool ndbcLoadJsonString(const char** p, const char* end, ndbcBuffer* text) {
+  const char* s = *p;
+  char* out = text->data + text->len;
+  unsigned long code;
+  unsigned long low;
+  int k;
+
+  while (s < end && *s != '\"') {
+    if (*s != '\\') {
+      *out++ = *s++;
+      continue;
+    }
+    if (++s == end) {
+      return false;
+    }
+    switch (*s++) {
+    case '\"':
+      *out++ = '\"';
+      break;
+    case '\\':
+      *out++ = '\\';
+      break;
+    case '/':
+      *out++ = '/';
+      break;
+    case 'b':
+      *out++ = '\b';
+      break;
+    case 'f':
+      *out++ = '\f';
+      break;
+    case 'n':
+      *out++ = '\n';
+      break;
+    case 'r':
+      *out++ = '\r';
+      break;
+    case 't':
+      *out++ = '\t';
+      break;
+    case 'u':
+      code = 0;
+      for (k = 0; k < 4; k++) {
+        if (s == end || !isxdigit((unsigned char) *s)) {
+          return false;
+        }
+        code = (code << 4) | (unsigned long) (isdigit((unsigned char) *s) ? *s - '0' : (tolower((unsigned char) *s) - 'a' + 10));
+        s++;
+      }
+      // Combine a surrogate pair into one code point.
+      if (code >= 0xD800 && code < 0xDC00 && end - s >= 6 && s[0] == '\\' && s[1] == 'u') {
+        low = 0;
+        for (k = 2; k < 6 && isxdigit((unsigned char) s[k]); k++) {
+          low = (low << 4) | (unsigned long) (isdigit((unsigned char) s[k]) ? s[k] - '0' : (tolower((unsigned char) s[k]) - 'a' + 10));
+        }
+        if (k == 6 && low >= 0xDC00 && low < 0xE000) {
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          s += 6;
+        }
+      }
+      if (code < 0x80) {
+        *out++ = (char) code;
+      } else if (code < 0x800) {
+        *out++ = (char) (0xC0 | (code >> 6));
+        *out++ = (char) (0x80 | (code & 0x3F));
+      } else if (code < 0x10000) {
+        *out++ = (char) (0xE0 | (code >> 12));
+        *out++ = (char) (0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (code & 0x3F));
+      } else {
+        *out++ = (char) (0xF0 | (code >> 18));
+        *out++ = (char) (0x80 | ((code >> 12) & 0x3F));
+        *out++ = (char) (0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char) (0x80 | (code & 0x3F));
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+  if (s == end) {
+    return false;
+  }
+  text->len = out - text->data;
+  *p = s + 1;
+  return true;
+}
+
+/* ndbc internal function ndbcLoadJsonRecord
+ * Reads the next line of an NDJSON file, which must hold one object, appending its members' values to text.
+ * Strings are decoded, numbers are kept as written, true and false become 1 and 0, and nested objects and arrays are
+ * kept as JSON text.  Members that are missing or null are null, and members not named by the job are ignored.
+ * Blank lines are skipped.
+ * start and len receive the position within text and length, or SQL_NULL_DATA, of each of the job's columns.
+ * line is working space for the line being parsed.
+ * Returns 1 for a record, 0 at the end of the file, -1 for a line that is not a JSON object (whose text is
+ * discarded), or -2 if memory could not be allocated.
+ */
+int ndbcLoadJsonRecord(ndbcLoadJob* job, ndbcLoadReader* reader, ndbcBuffer* line, ndbcBuffer* text,
+                       size_t* start, SQLLEN* len) {
+  size_t recordStart = text->len;
+  size_t valueStart;
+  const char* p;
+  const char* end;
+  const char* key;
+  size_t keyLen;
+  SQLSMALLINT f;
+  SQLSMALLINT column;
+  int depth;
+  bool isNull;
+  bool closed = false;
+  int c;
+
+  // Read the next line that is not blank.
+  do {
+    line->len = 0;
+    c = ndbcLoadGetc(reader);
+    if (c == -1) {
+      return 0;
+    }
+    while (c != -1 && c != '\n') {
+      if (!ndbcLoadPutc(line, c)) {
+        return -2;
+      }
+      c = ndbcLoadGetc(reader);
+    }
+    p = line->data;
+    end = line->data + line->len;
+    while (p < end && isspace((unsigned char) *p)) {
+      p++;
+    }
+  } while (p == end);
+  // Every value fits in the space its JSON text takes.
+  if (!ndbcBufferReserve(text, line->len)) {
+    return -2;
+  }
+  for (f = 0; f < job->columnCount; f++) {
+    len[f] = SQL_NULL_DATA;
+  }
+
+  if (*p++ != '{') {
+    return -1;
+  }
+  while (p < end && isspace((unsigned char) *p)) {
+    p++;
+  }
+  if (p < end && *p == '}') {
+    p++;
+    closed = true;
+  }
+  while (!closed) {
+    if (p == end || *p++ != '\"') {
+      break;
+    }
+    key = p;
+    while (p < end && *p != '\"') {
+      p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+    }
+    if (p == end) {
+      break;
+    }
+    keyLen = p - key;
+    p++;
+    // Names are compared in their JSON form, so names with escapes must be written the same way in columns.
+    column = -1;
+    for (f = 0; f < job->columnCount; f++) {
+      if (job->columnLen[f] == keyLen && memcmp(job->columns[f], key, keyLen) == 0) {
+        column = f;
+      }
+    }
+    while (p < end && isspace((unsigned char) *p)) {
+      p++;
+    }
+    if (p == end || *p++ != ':') {
+      break;
+    }
+    while (p < end && isspace((unsigned char) *p)) {
+      p++;
+    }
+    if (p == end) {
+      break;
+    }
+    isNull = false;
+    valueStart = text->len;
+    if (*p == '\"') {
+      p++;
+      if (!ndbcLoadJsonString(&p, end, text)) {
+        break;
+      }
+    } else if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+      p += 4;
+      isNull = true;
+    } else if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+      p += 4;
+      text->data[text->len++] = '1';
+    } else if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+      p += 5;
+      text->data[text->len++] = '0';
+    } else if (*p == '-' || isdigit((unsigned char) *p)) {
+      while (p < end && (isdigit((unsigned char) *p) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) {
+        text->data[text->len++] = *p++;
+      }
+    } else if (*p == '{' || *p == '[') {
+      // Copy nested values through to their matching close, skipping over brackets within strings.
+      depth = 0;
+      do {
+        if (*p == '\"') {
+          do {
+            if (*p == '\\' && p + 1 < end) {
+              text->data[text->len++] = *p++;
+            }
+            text->data[text->len++] = *p++;
+          } while (p < end && *p != '\"');
+          if (p == end) {
+            break;
           }
-          columnDesc = String::Concat(columnDesc, String::NewSymbol("q"));
+        } else if (*p == '{' || *p == '[') {
+          depth++;
+        } else if (*p == '}' || *p == ']') {
+          depth--;
+        }
+        text->data[text->len++] = *p++;
+      } while (p < end && depth > 0);
+      if (depth > 0) {
+        break;
+      }
+    } else {
+      break;
+    }
+    if (column >= 0) {
+      start[column] = valueStart;
+      len[column] = isNull ? SQL_NULL_DATA : (SQLLEN) (text->len - valueStart);
+    } else {
+      text->len = valueStart;
+    }
+    while (p < end && isspace((unsigned char) *p)) {
+      p++;
+    }
+    if (p < end && *p == ',') {
+      p++;
+      while (p < end && isspace((unsigned char) *p)) {
+        p++;
+      }
+    } else {
+      if (p < end && *p == '}') {
+        p++;
+        closed = true;
+      }
+      break;
+    }
+  }
+  while (p < end && isspace((unsigned char) *p)) {
+    p++;
+  }
+  if (!closed || p != end) {
+    text->len = recordStart;
+    return -1;
+  }
+  return 1;
+}
+
+/* ndbc internal function ndbcLoadBatch
+ * Inserts the records gathered for one batch of a bulk load, as text parameters bound column-wise from arena.
+ * start and len hold each record's fields as given by ndbcLoadCsvRecord or ndbcLoadJsonRecord, and recordNo holds
+ * each record's index in the file.  Rows the server rejects are counted as failed.
+ * Returns false, with the job's error set, if the batch could not be run.
+ */
+bool ndbcLoadBatch(ndbcLoadJob* job, SQLHANDLE statement, SQLSMALLINT fieldCount, ndbcBuffer* text, size_t* start,
+                   SQLLEN* len, double* recordNo, SQLUINTEGER count, ndbcArena* arena) {
+  SQLUSMALLINT* paramStatus;
+  SQLULEN* paramsProcessed;
+  SQLLEN width;
+  SQLLEN* ind;
+  char* data;
+  SQLSMALLINT f;
+  SQLUINTEGER r;
+  bool ok = true;
+
+  SQLFreeStmt(statement, SQL_CLOSE);
+  SQLFreeStmt(statement, SQL_RESET_PARAMS);
+  ndbcArenaReset(arena);
+  paramStatus = (SQLUSMALLINT*) ndbcArenaAlloc(arena, sizeof(SQLUSMALLINT) * count);
+  paramsProcessed = (SQLULEN*) ndbcArenaAlloc(arena, sizeof(SQLULEN));
+  if (paramStatus == NULL || paramsProcessed == NULL) {
+    job->error = "INTERNAL_ERROR";
+    return false;
+  }
+  if (SQLSetStmtAttr(statement, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0) == SQL_ERROR
+      || SQLSetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (SQLULEN) count, 0) == SQL_ERROR) {
+    if (count > 1) {
+      job->error = "SQL_ERROR";
+      return false;
+    }
+  }
+  SQLSetStmtAttr(statement, SQL_ATTR_PARAM_STATUS_PTR, (SQLPOINTER) paramStatus, 0);
+  SQLSetStmtAttr(statement, SQL_ATTR_PARAMS_PROCESSED_PTR, (SQLPOINTER) paramsProcessed, 0);
+
+  for (f = 0; f < fieldCount; f++) {
+    // Size each column to its longest value in the batch, leaving room for a null terminator.
+    width = 0;
+    for (r = 0; r < count; r++) {
+      if (len[(r * fieldCount) + f] > width) {
+        width = len[(r * fieldCount) + f];
+      }
+    }
+    data = ((size_t) width < ((size_t) -1) / count - 1) ? ndbcArenaAlloc(arena, (size_t) (width + 1) * count) : NULL;
+    ind = (SQLLEN*) ndbcArenaAlloc(arena, sizeof(SQLLEN) * count);
+    if (data == NULL || ind == NULL) {
+      job->error = "INTERNAL_ERROR";
+      return false;
+    }
+    for (r = 0; r < count; r++) {
+      ind[r] = len[(r * fieldCount) + f];
+      if (ind[r] != SQL_NULL_DATA) {
+        memcpy(data + (r * (width + 1)), text->data + start[(r * fieldCount) + f], ind[r]);
+        data[(r * (width + 1)) + ind[r]] = 0;
+      }
+    }
+    switch (SQLBindParameter(statement, (SQLUSMALLINT) (f + 1), SQL_PARAM_INPUT, SQL_C_CHAR,
+                             (width > 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR, (width > 0) ? width : 1, 0, data,
+                             width + 1, ind)) {
+    case SQL_ERROR:
+      job->error = "SQL_ERROR";
+      return false;
+    case SQL_INVALID_HANDLE:
+      job->error = "SQL_INVALID_HANDLE";
+      return false;
+    }
+  }
+
+  for (r = 0; r < count; r++) {
+    paramStatus[r] = SQL_PARAM_UNUSED;
+  }
+  *paramsProcessed = 0;
+  switch (SQLExecute(statement)) {
+  case SQL_ERROR:
+    // A batch that failed as a whole fails every row.
+    job->error = "SQL_ERROR";
+    ok = false;
+    if (*paramsProcessed == 0) {
+      for (r = 0; r < count; r++) {
+        paramStatus[r] = SQL_PARAM_ERROR;
+      }
+      *paramsProcessed = count;
+    }
+    break;
+  case SQL_INVALID_HANDLE:
+    job->error = "SQL_INVALID_HANDLE";
+    return false;
+  case SQL_NEED_DATA:
+    job->error = "SQL_NEED_DATA";
+    return false;
+  case SQL_STILL_EXECUTING:
+    job->error = "SQL_STILL_EXECUTING";
+    return false;
+  default:
+    // Drivers that do not report per-row statuses ran every row.
+    if (*paramsProcessed == 0) {
+      *paramsProcessed = count;
+    }
+  }
+  for (r = 0; r < count && r < *paramsProcessed; r++) {
+    if (paramStatus[r] == SQL_PARAM_ERROR) {
+      job->failed++;
+      if (job->errorCount < ndbcLoadMaxErrors) {
+        job->errors[job->errorCount++] = recordNo[r];
+      }
+    } else {
+      job->loaded++;
+    }
+  }
+  return ok;
+}
+
+/* ndbc internal function ndbcLoadWork
+ * Runs a bulk load on a libuv worker thread.
+ * The file is read in blocks, each batch of records is parsed into one text buffer, and the batch is inserted with
+ * ndbcLoadBatch.  Memory use depends on the batch size, not the size of the file.
+ * With a commit interval, autocommit is turned off for the load and restored afterwards.  Work since the last commit
+ * is rolled back if the load stops on an error.
+ */
+void ndbcLoadWork(uv_work_t* request) {
+  ndbcLoadJob* job = (ndbcLoadJob*) request->data;
+  ndbcLoadReader* reader = NULL;
+  ndbcBuffer text = { NULL, 0, 0 };
+  ndbcBuffer line = { NULL, 0, 0 };
+  ndbcArena arena = { NULL, NULL, 0 };
+  SQLHANDLE statement = NULL;
+  SQLSMALLINT fieldCount = job->columnCount;
+  SQLULEN autocommit = SQL_AUTOCOMMIT_ON;
+  SQLUINTEGER batchSize;
+  SQLUINTEGER count;
+  double pending = 0;
+  double* recordNo = NULL;
+  size_t* start = NULL;
+  SQLLEN* len = NULL;
+  bool transacted = false;
+  bool eof = false;
+  int status;
+
+  reader = (ndbcLoadReader*) malloc(sizeof(ndbcLoadReader));
+  if (reader == NULL) {
+    job->error = "INTERNAL_ERROR";
+    return;
+  }
+  reader->pos = 0;
+  reader->len = 0;
+  reader->file = fopen(job->file, "rb");
+  if (reader->file == NULL) {
+    job->error = "FILE_ERROR";
+    free(reader);
+    return;
+  }
+
+  switch (SQLAllocHandle(SQL_HANDLE_STMT, job->connection, &statement)) {
+  case SQL_ERROR:
+    job->error = "SQL_ERROR";
+    statement = NULL;
+    break;
+  case SQL_INVALID_HANDLE:
+    job->error = "SQL_INVALID_HANDLE";
+    statement = NULL;
+    break;
+  default:
+    if (SQLPrepare(statement, (SQLCHAR*) job->query, SQL_NTS) == SQL_ERROR) {
+      job->error = "SQL_ERROR";
+    } else if (!job->ndjson && (SQLNumParams(statement, &fieldCount) == SQL_ERROR || fieldCount < 1)) {
+      job->error = "INVALID_ARGUMENT";
+    }
+  }
+
+  if (job->error == NULL) {
+    batchSize = ndbcParamsetLimit(statement, job->batchSize);
+    if (batchSize > ((size_t) -1) / (sizeof(size_t) + sizeof(SQLLEN)) / fieldCount) {
+      batchSize = (SQLUINTEGER) (((size_t) -1) / (sizeof(size_t) + sizeof(SQLLEN)) / fieldCount);
+    }
+    start = (size_t*) malloc(sizeof(size_t) * batchSize * fieldCount);
+    len = (SQLLEN*) malloc(sizeof(SQLLEN) * batchSize * fieldCount);
+    recordNo = (double*) malloc(sizeof(double) * batchSize);
+    if (start == NULL || len == NULL || recordNo == NULL) {
+      job->error = "INTERNAL_ERROR";
+    }
+  }
+  if (job->error == NULL && job->commitInterval > 0) {
+    SQLGetConnectAttr(job->connection, SQL_ATTR_AUTOCOMMIT, &autocommit, 0, NULL);
+    if (SQLSetConnectAttr(job->connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0) == SQL_ERROR) {
+      job->error = "SQL_ERROR";
+    } else {
+      transacted = true;
+    }
+  }
+  if (job->error == NULL && !job->ndjson && job->header) {
+    if (ndbcLoadCsvRecord(job, reader, fieldCount, &text, start, len) == -2) {
+      job->error = "INTERNAL_ERROR";
+    }
+    text.len = 0;
+  }
+
+  while (job->error == NULL && !eof) {
+    // Gather a batch of records, counting those that can not be parsed as failed.
+    count = 0;
+    text.len = 0;
+    while (count < batchSize) {
+      if (job->ndjson) {
+        status = ndbcLoadJsonRecord(job, reader, &line, &text, start + (count * fieldCount), len + (count * fieldCount));
+      } else {
+        status = ndbcLoadCsvRecord(job, reader, fieldCount, &text, start + (count * fieldCount), len + (count * fieldCount));
+      }
+      if (status == 0) {
+        eof = true;
+        break;
+      }
+      if (status == -2) {
+        job->error = "INTERNAL_ERROR";
+        break;
+      }
+      if (status == -1) {
+        job->failed++;
+        if (job->errorCount < ndbcLoadMaxErrors) {
+          job->errors[job->errorCount++] = job->records;
+        }
+      } else {
+        recordNo[count] = job->records;
+        count++;
+      }
+      job->records++;
+    }
+    if (job->error != NULL || count == 0) {
+      break;
+    }
+    pending -= job->loaded;
+    ndbcLoadBatch(job, statement, fieldCount, &text, start, len, recordNo, count, &arena);
+    pending += job->loaded;
+    if (job->error == NULL && transacted && pending >= job->commitInterval) {
+      if (SQLEndTran(SQL_HANDLE_DBC, job->connection, SQL_COMMIT) == SQL_ERROR) {
+        job->error = "SQL_ERROR";
+      } else {
+        pending = 0;
+      }
+    }
+  }
+
+  if (transacted) {
+    if (job->error == NULL && pending > 0 && SQLEndTran(SQL_HANDLE_DBC, job->connection, SQL_COMMIT) == SQL_ERROR) {
+      job->error = "SQL_ERROR";
+    }
+    if (job->error != NULL) {
+      SQLEndTran(SQL_HANDLE_DBC, job->connection, SQL_ROLLBACK);
+      job->loaded -= pending;
+    }
+    if (autocommit != SQL_AUTOCOMMIT_OFF) {
+      SQLSetConnectAttr(job->connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) autocommit, 0);
+    }
+  }
+  if (statement != NULL) {
+    SQLFreeHandle(SQL_HANDLE_STMT, statement);
+  }
+  fclose(reader->file);
+  free(reader);
+  free(text.data);
+  free(line.data);
+  ndbcFreeArena(&arena);
+  free(start);
+  free(len);
+  free(recordNo);
+}
+
+/* ndbc internal function ndbcLoadDone
+ * Reports the outcome of a bulk load to its callback on the main thread, then frees the job.
+ */
+void ndbcLoadDone(uv_work_t* request) {
+  HandleScope scope;
+  ndbcLoadJob* job = (ndbcLoadJob*) request->data;
+  Local<Object> result = Object::New();
+  Local<Array> errors = Array::New(job->errorCount);
+  Handle<Value> argv[2];
+  SQLSMALLINT f;
+  SQLUINTEGER i;
+  TryCatch tryCatch;
+
+  for (i = 0; i < job->errorCount; i++) {
+    errors->Set(i, Number::New(job->errors[i]));
+  }
+  result->Set(String::NewSymbol("records"), Number::New(job->records));
+  result->Set(String::NewSymbol("loaded"), Number::New(job->loaded));
+  result->Set(String::NewSymbol("failed"), Number::New(job->failed));
+  result->Set(String::NewSymbol("errors"), errors);
+  argv[0] = (job->error != NULL) ? Handle<Value>(String::NewSymbol(job->error)) : Handle<Value>(Null());
+  argv[1] = result;
+  job->callback->Call(Context::GetCurrent()->Global(), 2, argv);
+
+  job->callback.Dispose();
+  for (f = 0; f < job->columnCount; f++) {
+    free(job->columns[f]);
+  }
+  free(job->columns);
+  free(job->columnLen);
+  free(job->query);
+  free(job->file);
+  free(job);
+  if (tryCatch.HasCaught()) {
+    node::FatalException(tryCatch);
+  }
+}
+
+/* ndbc internal function ndbcCopyString
+ * Returns a null terminated, malloc'ed UTF-8 copy of a javascript string, or NULL if memory could not be allocated.
+ * len, if not NULL, receives the length of the copy.
+ */
+char* ndbcCopyString(Handle<Value> value, size_t* len) {
+  String::Utf8Value text(value->ToString());
+  char* copy = (char*) malloc(text.length() + 1);
+
+  if (copy != NULL) {
+    memcpy(copy, *text, text.length() + 1);
+    if (len != NULL) {
+      *len = text.length();
+    }
+  }
+  return copy;
+}
+
+/* ndbc custom function ndbcBulkLoad
+ * ndbcBulkLoad(connection, query, file, [options], callback)
+ * connection - A connection handle.
+ * query - An insert query with a parameter marker ('?') for each field of the file, such as
+ *         'INSERT INTO T (A, B, C) VALUES (?, ?, ?)'.
+ * file - The path of a local CSV or NDJSON file.
+ * options - An object with any of the following properties:
+ *   format - 'csv' or 'ndjson'.  Defaults to 'ndjson' for files ending in .ndjson, .jsonl or .json, otherwise 'csv'.
+ *   delimiter - The CSV field separator.  Defaults to ','.
+ *   header - True to skip the first CSV record, which holds column names.  Defaults to false.
+ *   columns - For NDJSON, an array holding the member name that supplies each parameter, in order.  Required.
+ *   batchSize - The number of rows sent to the server in each execution.  Defaults to 1000.
+ *   commitInterval - Commit after at least this many rows, rounded up to whole batches, with autocommit turned off
+ *                    for the load.  Defaults to 0, which leaves transactions to the connection's settings.
+ * callback - A function called as callback(error, result) when the load ends.
+ *   error - null, or a string describing the error that stopped the load:
+ *           'FILE_ERROR' if the file could not be opened, or one of the usual error strings.
+ *   result - An object:
+ *     records - The number of records read, not counting a CSV header.
+ *     loaded - The number of records inserted.  Records rolled back after an error are not counted.
+ *     failed - The number of records that could not be parsed or were rejected by the server.
+ *     errors - The index of each of the first 1000 failed records, counting from 0 after any header.
+ *
+ * Reads, parses and inserts the file on a worker thread, so no javascript values are created for the records.
+ * CSV follows RFC 4180, with an empty unquoted field read as null, so a blank line of a one column file is a null
+ * record while other blank lines are skipped.  Each NDJSON line holds one object, whose missing and null members are
+ * read as null.  Values are bound as text and converted to the column types by the driver.
+ * The load runs on its own statement handle.  The connection must not be used or freed until the callback is called.
+ * Returns 'SQL_SUCCESS' once the load has been started, or a string describing the error.
+ */
+Handle<Value> ndbcBulkLoad(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  ndbcLoadJob* job = NULL;
+  Local<Object> options;
+  Local<Array> columns;
+  Local<Value> callback;
+  size_t fileLen = 0;
+  SQLSMALLINT f;
+  bool ok = true;
+
+  if (args.Length() >= 4) {
+    callback = args[args.Length() - 1];
+  }
+  if (args.Length() < 4 || !callback->IsFunction() || (args.Length() >= 5 && !args[3]->IsObject())) {
+    ok = false;
+    retVal = ndbcINVALID_ARGUMENT;
+  }
+  if (ok) {
+    job = (ndbcLoadJob*) malloc(sizeof(ndbcLoadJob));
+    if (job == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+  if (ok) {
+    job->request.data = job;
+    job->connection = (SQLHANDLE) External::Unwrap(args[0]);
+    job->columns = NULL;
+    job->columnLen = NULL;
+    job->columnCount = 0;
+    job->header = false;
+    job->delimiter = ',';
+    job->batchSize = 1000;
+    job->commitInterval = 0;
+    job->error = NULL;
+    job->records = 0;
+    job->loaded = 0;
+    job->failed = 0;
+    job->errorCount = 0;
+    job->query = ndbcCopyString(args[1], NULL);
+    job->file = ndbcCopyString(args[2], &fileLen);
+    if (job->query == NULL || job->file == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    }
+  }
+  if (ok) {
+    job->ndjson = (fileLen >= 7 && strcmp(job->file + fileLen - 7, ".ndjson") == 0)
+                  || (fileLen >= 6 && strcmp(job->file + fileLen - 6, ".jsonl") == 0)
+                  || (fileLen >= 5 && strcmp(job->file + fileLen - 5, ".json") == 0);
+    if (args.Length() >= 5) {
+      options = args[3]->ToObject();
+      if (options->Has(String::NewSymbol("format"))) {
+        String::AsciiValue format(options->Get(String::NewSymbol("format"))->ToString());
+        if (strcmp(*format, "csv") == 0) {
+          job->ndjson = false;
+        } else if (strcmp(*format, "ndjson") == 0) {
+          job->ndjson = true;
+        } else {
+          ok = false;
+          retVal = ndbcINVALID_ARGUMENT;
+        }
+      }
+      if (options->Has(String::NewSymbol("delimiter"))) {
+        String::AsciiValue delimiter(options->Get(String::NewSymbol("delimiter"))->ToString());
+        if (delimiter.length() != 1 || **delimiter == '\"' || **delimiter == '\n' || **delimiter == '\r') {
+          ok = false;
+          retVal = ndbcINVALID_ARGUMENT;
+        } else {
+          job->delimiter = **delimiter;
+        }
+      }
+      job->header = options->Get(String::NewSymbol("header"))->BooleanValue();
+      if (options->Has(String::NewSymbol("batchSize"))) {
+        job->batchSize = options->Get(String::NewSymbol("batchSize"))->Uint32Value();
+        if (job->batchSize < 1) {
+          ok = false;
+          retVal = ndbcINVALID_ARGUMENT;
+        }
+      }
+      job->commitInterval = options->Get(String::NewSymbol("commitInterval"))->Uint32Value();
+      if (options->Get(String::NewSymbol("columns"))->IsArray()) {
+        columns = Local<Array>::Cast(options->Get(String::NewSymbol("columns")));
+      }
+    }
+  }
+  if (ok && job->ndjson) {
+    // NDJSON records are matched to parameters by member name.
+    if (columns.IsEmpty() || columns->Length() < 1 || columns->Length() > 32767) {
+      ok = false;
+      retVal = ndbcINVALID_ARGUMENT;
+    } else {
+      job->columns = (char**) calloc(columns->Length(), sizeof(char*));
+      job->columnLen = (size_t*) malloc(sizeof(size_t) * columns->Length());
+      if (job->columns == NULL || job->columnLen == NULL) {
+        retVal = ndbcINTERNAL_ERROR;
+        ok = false;
+      }
+      for (f = 0; ok && f < (SQLSMALLINT) columns->Length(); f++) {
+        job->columnCount++;
+        job->columns[f] = ndbcCopyString(columns->Get(f), &job->columnLen[f]);
+        if (job->columns[f] == NULL) {
+          retVal = ndbcINTERNAL_ERROR;
+          ok = false;
         }
-        columnDesc = String::Concat(columnDesc, Integer::New(*dataLen)->ToString());
       }
     }
-    if (ok) {
-      // Encode the total record length to the output
-      retVal = String::Concat(retVal, String::New("l"));
-      retVal = String::Concat(retVal, Integer::New(recLen)->ToString());
-      // Concatenate the column description string to the output
-      retVal = String::Concat(retVal, columnDesc);
+  }
+
+  if (ok) {
+    job->callback = Persistent<Function>::New(Local<Function>::Cast(callback));
+    if (uv_queue_work(uv_default_loop(), &job->request, ndbcLoadWork, ndbcLoadDone) != 0) {
+      job->callback.Dispose();
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
+    } else {
+      retVal = ndbcSQL_SUCCESS;
+    }
+  }
+  if (!ok && job != NULL) {
+    for (f = 0; f < job->columnCount; f++) {
+      free(job->columns[f]);
     }
+    free(job->columns);
+    free(job->columnLen);
+    free(job->query);
+    free(job->file);
+    free(job);
   }
-  
-  free(columns);
-  free(dataType);
-  free(dataLen);
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -6544,314 +13187,452 @@ catch (...) {
   return scope.Close(retVal);
 }
 
-/* ndbc custom function ndbcJsonHeader
- * ndbcJsonHeader(statement)
- * statement - An statement handle that has an available result set.
- *
- * Returns a Json-formatted array with column names for the result set.
- * Returns a leading [ character to begin the array of records.
+/* ndbc internal type ndbcPutChunk
+ * A chunk of stream data waiting to be sent by PutStream.
+ * next - The following chunk, or NULL for the last chunk.
+ * buffer - The Buffer holding the data, kept alive until it is sent.  Empty for chunks that were copied.
+ * copy - A UTF-8 copy of a string chunk, or NULL for Buffers.
+ * data - The data to send.
+ * len - The number of bytes to send.
  */
-Handle<Value> ndbcJsonHeader(const Arguments& args) {
-  HandleScope scope;
-  Local<String> retVal;
-try {
-  SQLSMALLINT* columns = (SQLSMALLINT*) malloc(sizeof(SQLSMALLINT*));
-  SQLCHAR* colName;
+typedef struct ndbcPutChunk {
+  struct ndbcPutChunk* next;
+  Persistent<Object> buffer;
+  char* copy;
+  char* data;
+  size_t len;
+} ndbcPutChunk;
 
-  colName = (SQLCHAR*) malloc(256);
+/* ndbc internal type ndbcPutJob
+ * The state of a PutStream call.
+ * request - The libuv work request that runs SQLPutData or SQLParamData.  Its data points back at the job.
+ * stream - The stream being read.
+ * callback - The javascript function called with the outcome.
+ * onData, onEnd, onError - The listeners added to the stream, removed when the job finishes.
+ * statement - The statement handle whose parameter data is sent.
+ * head - The chunk being sent, or the next chunk to send.  NULL if none are waiting.
+ * tail - The last chunk waiting.
+ * busy - True while a worker thread is running SQLPutData or SQLParamData.
+ * paused - True while the stream is paused.
+ * ended - True once the stream has ended.
+ * failed - True if the stream reported an error.
+ * status - The return code of the worker's last call.
+ * token - The next data-at-execution parameter, as returned by SQLParamData.
+ */
+typedef struct {
+  uv_work_t request;
+  Persistent<Object> stream;
+  Persistent<Function> callback;
+  Persistent<Function> onData;
+  Persistent<Function> onEnd;
+  Persistent<Function> onError;
+  SQLHANDLE statement;
+  ndbcPutChunk* head;
+  ndbcPutChunk* tail;
+  bool busy;
+  bool paused;
+  bool ended;
+  bool failed;
+  SQLRETURN status;
+  SQLPOINTER token;
+} ndbcPutJob;
 
-  SQLUSMALLINT i;
-  bool ok = true;
+/* ndbc internal function ndbcCallMethod
+ * Calls the method <name> of a javascript object, if it has one.
+ */
+void ndbcCallMethod(Handle<Object> object, const char* name, int argc, Handle<Value> argv[]) {
+  Local<Value> method = object->Get(String::NewSymbol(name));
 
-  // Call SQLNumResultCols to get the number of columns in the result set
-  switch (SQLNumResultCols((SQLHANDLE) External::Unwrap(args[0]), columns)) {
-  case SQL_ERROR:
-    retVal = ndbcSQL_ERROR;
-    break;
-  case SQL_INVALID_HANDLE:
-    retVal = ndbcSQL_INVALID_HANDLE;
-    break;
-  case SQL_STILL_EXECUTING:
-    retVal = ndbcSQL_STILL_EXECUTING;
-    break;
-  default:
-    // Write the header array to the output
-    retVal = String::New("[[");
-    // Call SQLDescribeCol for each column in the result set
-    switch (SQLDescribeCol((SQLHANDLE) External::Unwrap(args[0]), 1, colName, 255, NULL, NULL, NULL, NULL, NULL)){
+  if (method->IsFunction()) {
+    Local<Function>::Cast(method)->Call(object, argc, argv);
+  }
+}
+
+/* ndbc internal function ndbcPutWork
+ * Sends the chunk at the head of a PutStream job on a libuv worker thread.
+ * Once the stream has ended and every chunk has been sent, calls SQLParamData instead, which runs the query or moves
+ * to the next data-at-execution parameter.
+ */
+void ndbcPutWork(uv_work_t* request) {
+  ndbcPutJob* job = (ndbcPutJob*) request->data;
+
+  if (job->head != NULL) {
+    job->status = SQLPutData(job->statement, (SQLPOINTER) job->head->data, (SQLLEN) job->head->len);
+  } else {
+    job->status = SQLParamData(job->statement, &job->token);
+  }
+}
+
+/* ndbc internal function ndbcFreePutChunk
+ * Releases a chunk sent or discarded by PutStream.
+ */
+void ndbcFreePutChunk(ndbcPutChunk* chunk) {
+  if (!chunk->buffer.IsEmpty()) {
+    chunk->buffer.Dispose();
+  }
+  free(chunk->copy);
+  free(chunk);
+}
+
+/* ndbc internal function ndbcPutFinish
+ * Ends a PutStream job: removes its listeners from the stream, frees the job and calls its callback.
+ */
+void ndbcPutFinish(ndbcPutJob* job, Handle<Value> error, Handle<Value> result) {
+  Persistent<Function> callback = job->callback;
+  Handle<Value> argv[2];
+  ndbcPutChunk* chunk;
+
+  argv[0] = String::NewSymbol("data");
+  argv[1] = job->onData;
+  ndbcCallMethod(job->stream, "removeListener", 2, argv);
+  argv[0] = String::NewSymbol("end");
+  argv[1] = job->onEnd;
+  ndbcCallMethod(job->stream, "removeListener", 2, argv);
+  argv[0] = String::NewSymbol("error");
+  argv[1] = job->onError;
+  ndbcCallMethod(job->stream, "removeListener", 2, argv);
+  if (!error->IsNull()) {
+    // Nothing reads the rest of a failed stream, so release it: destroyed if it can be, eg. closing the file of an
+    // fs.ReadStream, and otherwise resumed so it is not left paused holding its source open.
+    if (job->stream->Get(String::NewSymbol("destroy"))->IsFunction()) {
+      ndbcCallMethod(job->stream, "destroy", 0, NULL);
+    } else {
+      ndbcCallMethod(job->stream, "resume", 0, NULL);
+    }
+  }
+  while (job->head != NULL) {
+    chunk = job->head;
+    job->head = chunk->next;
+    ndbcFreePutChunk(chunk);
+  }
+  job->stream.Dispose();
+  job->onData.Dispose();
+  job->onEnd.Dispose();
+  job->onError.Dispose();
+  free(job);
+
+  TryCatch tryCatch;
+  argv[0] = error;
+  argv[1] = result;
+  callback->Call(Context::GetCurrent()->Global(), 2, argv);
+  callback.Dispose();
+  if (tryCatch.HasCaught()) {
+    node::FatalException(tryCatch);
+  }
+}
+
+void ndbcPutDone(uv_work_t* request);
+
+/* ndbc internal function ndbcPutNext
+ * Starts the next step of a PutStream job, unless one is running.
+ * Sends the next waiting chunk, finishes the parameter once the stream has ended, or resumes the stream to get more.
+ * A stream error abandons the query with SQLCancel.
+ */
+void ndbcPutNext(ndbcPutJob* job) {
+  if (job->busy) {
+    return;
+  }
+  if (job->failed) {
+    SQLCancel(job->statement);
+    ndbcPutFinish(job, String::NewSymbol("STREAM_ERROR"), Undefined());
+  } else if (job->head != NULL || job->ended) {
+    job->busy = true;
+    if (uv_queue_work(uv_default_loop(), &job->request, ndbcPutWork, ndbcPutDone) != 0) {
+      job->busy = false;
+      SQLCancel(job->statement);
+      ndbcPutFinish(job, ndbcINTERNAL_ERROR, Undefined());
+    }
+  } else if (job->paused) {
+    job->paused = false;
+    ndbcCallMethod(job->stream, "resume", 0, NULL);
+  }
+}
+
+/* ndbc internal function ndbcPutDone
+ * Handles the outcome of a PutStream step on the main thread.
+ * After a chunk is sent, moves on to the next step.  After SQLParamData, reports the outcome to the callback.
+ */
+void ndbcPutDone(uv_work_t* request) {
+  HandleScope scope;
+  ndbcPutJob* job = (ndbcPutJob*) request->data;
+  ndbcPutChunk* chunk = job->head;
+
+  job->busy = false;
+  if (chunk != NULL) {
+    job->head = chunk->next;
+    ndbcFreePutChunk(chunk);
+    switch (job->status) {
     case SQL_ERROR:
-      retVal = ndbcSQL_ERROR;
-      ok = false;
+      SQLCancel(job->statement);
+      ndbcPutFinish(job, ndbcSQL_ERROR, Undefined());
       break;
     case SQL_INVALID_HANDLE:
-      retVal = ndbcSQL_INVALID_HANDLE;
-      ok = false;
+      ndbcPutFinish(job, ndbcSQL_INVALID_HANDLE, Undefined());
       break;
     case SQL_STILL_EXECUTING:
-      retVal = ndbcSQL_STILL_EXECUTING;
-      ok = false;
+      SQLCancel(job->statement);
+      ndbcPutFinish(job, ndbcSQL_STILL_EXECUTING, Undefined());
       break;
     default:
-      retVal = String::Concat(retVal, String::New("\""));
-      retVal = String::Concat(retVal, String::New((char*) colName));
-      retVal = String::Concat(retVal, String::New("\""));
+      ndbcPutNext(job);
     }
-    for (i = 2; i <= *columns && ok; i++) {
-      switch (SQLDescribeCol((SQLHANDLE) External::Unwrap(args[0]), i, colName, 255, NULL, NULL, NULL, NULL, NULL)) {
-      case SQL_ERROR:
-        retVal = ndbcSQL_ERROR;
-        ok = false;
-        break;
-      case SQL_INVALID_HANDLE:
-        retVal = ndbcSQL_INVALID_HANDLE;
-        ok = false;
-        break;
-      case SQL_STILL_EXECUTING:
-        retVal = ndbcSQL_STILL_EXECUTING;
-        ok = false;
-        break;
-      default:
-        retVal = String::Concat(retVal, String::New(",\""));
-        retVal = String::Concat(retVal, String::New((char*) colName));
-        retVal = String::Concat(retVal, String::New("\""));
-      }
+    return;
+  }
+  switch (job->status) {
+  case SQL_ERROR:
+    ndbcPutFinish(job, ndbcSQL_ERROR, Undefined());
+    break;
+  case SQL_INVALID_HANDLE:
+    ndbcPutFinish(job, ndbcSQL_INVALID_HANDLE, Undefined());
+    break;
+  case SQL_STILL_EXECUTING:
+    ndbcPutFinish(job, ndbcSQL_STILL_EXECUTING, Undefined());
+    break;
+  case SQL_NEED_DATA:
+    ndbcPutFinish(job, Null(), Integer::NewFromUnsigned((uint32_t) (SQLULEN) job->token));
+    break;
+  case SQL_NO_DATA:
+    ndbcPutFinish(job, Null(), ndbcSQL_NO_DATA);
+    break;
+  case SQL_PARAM_DATA_AVAILABLE:
+    ndbcPutFinish(job, Null(), ndbcSQL_PARAM_DATA_AVAILABLE);
+    break;
+  default:
+    ndbcPutFinish(job, Null(), ndbcSQL_SUCCESS);
+  }
+}
+
+/* ndbc internal function ndbcPutStreamData
+ * The 'data' listener added to a stream by PutStream.
+ * Queues the chunk and pauses the stream, which is resumed once every queued chunk has been sent.
+ */
+Handle<Value> ndbcPutStreamData(const Arguments& args) {
+  HandleScope scope;
+  ndbcPutJob* job = (ndbcPutJob*) External::Unwrap(args.Data());
+  ndbcPutChunk* chunk = (ndbcPutChunk*) malloc(sizeof(ndbcPutChunk));
+  size_t len = 0;
+
+  if (chunk == NULL) {
+    job->failed = true;
+  } else {
+    chunk->next = NULL;
+    chunk->copy = NULL;
+    if (node::Buffer::HasInstance(args[0])) {
+      chunk->buffer = Persistent<Object>::New(args[0]->ToObject());
+      chunk->data = node::Buffer::Data(args[0]->ToObject());
+      chunk->len = node::Buffer::Length(args[0]->ToObject());
+    } else {
+      // Streams with an encoding set emit strings, which are sent as UTF-8.
+      chunk->buffer = Persistent<Object>();
+      chunk->copy = ndbcCopyString(args[0], &len);
+      chunk->data = chunk->copy;
+      chunk->len = len;
     }
-    if (ok) {
-      // Add the closing brace
-      retVal = String::Concat(retVal, String::New("]"));
+    if (chunk->buffer.IsEmpty() && chunk->copy == NULL) {
+      free(chunk);
+      job->failed = true;
+    } else {
+      if (job->tail != NULL && job->head != NULL) {
+        job->tail->next = chunk;
+      } else {
+        job->head = chunk;
+      }
+      job->tail = chunk;
     }
   }
-  
-  free(columns);
-  free(colName);
+  if (!job->paused) {
+    job->paused = true;
+    ndbcCallMethod(job->stream, "pause", 0, NULL);
+  }
+  ndbcPutNext(job);
+  return scope.Close(Undefined());
 }
-catch (...) {
-  retVal = ndbcINTERNAL_ERROR;
+
+/* ndbc internal function ndbcPutStreamEnd
+ * The 'end' listener added to a stream by PutStream.
+ */
+Handle<Value> ndbcPutStreamEnd(const Arguments& args) {
+  HandleScope scope;
+  ndbcPutJob* job = (ndbcPutJob*) External::Unwrap(args.Data());
+
+  job->ended = true;
+  ndbcPutNext(job);
+  return scope.Close(Undefined());
 }
-  return scope.Close(retVal);
+
+/* ndbc internal function ndbcPutStreamError
+ * The 'error' listener added to a stream by PutStream.
+ */
+Handle<Value> ndbcPutStreamError(const Arguments& args) {
+  HandleScope scope;
+  ndbcPutJob* job = (ndbcPutJob*) External::Unwrap(args.Data());
+
+  job->failed = true;
+  ndbcPutNext(job);
+  return scope.Close(Undefined());
 }
 
-/* ndbc custom function ndbcJsonData
- * ndbcJsonData(statement, rowdesc, [rows])
- * statement - An statement handle that has an available result set.
- * rowdesc - A string describing the row format produced by ndbcJsonDescribe.
- * rows - The number of rows to output.  Defaults to 1.
+/* ndbc custom function ndbcPutStream
+ * ndbcPutStream(statement, stream, callback)
+ * statement - An statement handle whose last call to SQLParamData returned a parameter number.
+ * stream - A readable stream supplying the parameter's value, such as one from fs.createReadStream.
+ *          Buffers are sent as they are, and strings (from streams with an encoding set) as UTF-8.
+ * callback - A function called as callback(error, result) once the stream has been sent.
+ *   error - null, or a string describing the error: 'STREAM_ERROR' if the stream emitted an error, or one of the
+ *           usual error strings.  After an error, the query is cancelled.
+ *   result - What SQLParamData returned after the value was sent: 'SQL_SUCCESS' or 'SQL_NO_DATA' once the query has
+ *            run, or the number of the next data-at-execution parameter, which can be sent with another PutStream.
  *
- * Returns a Json-formatted array with column data for the next <length> rows in the result set.
- * Returns truncated results if the number of remaining rows is less than the number of requested rows.
- * Returns a leading comma before each row of data to continue the array of records (assumes this will be
- * concatenated with the results of ndbcJsonHeader).
- * Returns a trailing ']' if there is no more result set data, to close the array of records.
- * Returns SQL_NO_DATA if the end of the result set has already been reached.
+ * Sends the stream's data with SQLPutData, then calls SQLParamData, on worker threads.
+ * The stream is paused while its data is sent, so memory use stays at about one chunk however large the value is.
+ * The statement must not be used until the callback is called.
+ * Returns 'SQL_SUCCESS' once the stream is being read, or a string describing the error.
  */
-Handle<Value> ndbcJsonData(const Arguments& args) {
+Handle<Value> ndbcPutStream(const Arguments& args) {
   HandleScope scope;
   Local<Value> retVal;
 try {
-
-  SQLSMALLINT columns = 0;
-  SQLINTEGER recLen = 0;
-  SQLUSMALLINT i;
-  SQLUSMALLINT j;
-  SQLINTEGER k;
-  SQLUSMALLINT l;
-  SQLUINTEGER r = 0;
-  SQLUINTEGER rows;
-  SQLUINTEGER colLen;
-  char* recData;
-  char* serialize;
-  SQLCHAR** rowData;
-  SQLLEN** rowInd;
-  SQLUINTEGER* rowLen;
+  ndbcPutJob* job = NULL;
+  Local<Object> stream;
+  Handle<Value> argv[2];
   bool ok = true;
-  bool data = true;
-  char* rowDesc;
-
-  if (args.Length() == 3) {
-    rows = (SQLUINTEGER) args[2]->Uint32Value();
-  } else {
-    rows = 1;
-  }
 
-  // Parse the row description string.
-  String::AsciiValue rawVal(args[1]->ToString());
-  rowDesc = (char*) *rawVal;
-  if (rowDesc[0] == 'c') {
-    // Extract the column count from rowDesc.
-    for (i = 1; rowDesc[i] > 47 && rowDesc[i] < 58; i++) {
-      columns *= 10;
-      columns += rowDesc[i] - 48;
-    }
-  } else {
-    retVal = ndbcINVALID_ARGUMENT;
+  if (!args[1]->IsObject() || !args[1]->ToObject()->Get(String::NewSymbol("on"))->IsFunction() || !args[2]->IsFunction()) {
     ok = false;
-  }
-  if (ok && rowDesc[i] == 'l') {
-    // Extract the record length from rowDesc.
-    for (i++; rowDesc[i] > 47 && rowDesc[i] < 58; i++) {
-      recLen *= 10;
-      recLen += rowDesc[i] - 48;
-    }
-    retVal = Integer::New(recLen);
-  } else {
     retVal = ndbcINVALID_ARGUMENT;
-    ok = false;
   }
   if (ok) {
-    // Allocate output and serialization buffers.
-    recData = (char*) malloc((recLen * rows) + 1); // Add 1 for null termination
-    serialize = (char*) malloc(columns + 1); // Add 1 for null termination
-    serialize[columns] = 0; // Manually supply null terminating character for serialize string.
-    rowData = (SQLCHAR**) malloc(sizeof(SQLCHAR*) * columns);
-    rowInd = (SQLLEN**) malloc(sizeof(SQLLEN*) * columns);
-    rowLen = (SQLUINTEGER*) malloc(sizeof(SQLUINTEGER) * columns);
-    j = 0;
-    while (ok && rowDesc[i] != 0 && j < columns) {
-      if (rowDesc[i] == 'q' || rowDesc[i] == 'b' || rowDesc[i] == 'n') {
-        // Copy serialization type to the serialization buffer.
-        serialize[j] = rowDesc[i];
-        // Extract the field's buffer size from rowDesc.
-        colLen= 0;
-        for (i++; rowDesc[i] > 47 && rowDesc[i] < 58; i++) {
-          colLen *= 10;
-          colLen += rowDesc[i] - 48;
-        }
-        // Allocate the column output buffer.
-        rowData[j] = (SQLCHAR*) malloc(colLen + 1); // Add 1 for null termination.
-        rowInd[j] = (SQLLEN*) malloc(sizeof(SQLLEN));
-        rowLen[j] = colLen;
-        // Bind the column output buffer to the result set column.
-        switch (SQLBindCol((SQLHANDLE) External::Unwrap(args[0]), j + 1, SQL_C_CHAR, (SQLPOINTER) rowData[j], colLen, rowInd[j])) {
-        case SQL_ERROR:
-          retVal = ndbcSQL_ERROR;
-          ok = false;
-          break;
-        case SQL_INVALID_HANDLE:
-          retVal = ndbcSQL_INVALID_HANDLE;
-          ok = false;
-          break;
-        }
-        j++;
-      } else {
-        retVal = ndbcINVALID_ARGUMENT;
-        ok = false;
-        break;
-      }
+    job = (ndbcPutJob*) malloc(sizeof(ndbcPutJob));
+    if (job == NULL) {
+      retVal = ndbcINTERNAL_ERROR;
+      ok = false;
     }
   }
-  retVal = Integer::NewFromUnsigned(j);
-  
   if (ok) {
-    recData[0] = 0;
-    k = 0;
-    // Fetch the specified number of rows.
-    for (i = 0; ok && data && i < rows; i++) {
-      switch (SQLFetch((SQLHANDLE) External::Unwrap(args[0]))) {
+    stream = args[1]->ToObject();
+    job->request.data = job;
+    job->statement = (SQLHANDLE) External::Unwrap(args[0]);
+    job->head = NULL;
+    job->tail = NULL;
+    job->busy = false;
+    job->paused = false;
+    job->ended = false;
+    job->failed = false;
+    job->token = NULL;
+    job->stream = Persistent<Object>::New(stream);
+    job->callback = Persistent<Function>::New(Local<Function>::Cast(args[2]));
+    job->onData = Persistent<Function>::New(FunctionTemplate::New(ndbcPutStreamData, External::Wrap(job))->GetFunction());
+    job->onEnd = Persistent<Function>::New(FunctionTemplate::New(ndbcPutStreamEnd, External::Wrap(job))->GetFunction());
+    job->onError = Persistent<Function>::New(FunctionTemplate::New(ndbcPutStreamError, External::Wrap(job))->GetFunction());
+    argv[0] = String::NewSymbol("data");
+    argv[1] = job->onData;
+    ndbcCallMethod(stream, "on", 2, argv);
+    argv[0] = String::NewSymbol("end");
+    argv[1] = job->onEnd;
+    ndbcCallMethod(stream, "on", 2, argv);
+    argv[0] = String::NewSymbol("error");
+    argv[1] = job->onError;
+    ndbcCallMethod(stream, "on", 2, argv);
+    retVal = ndbcSQL_SUCCESS;
+  }
+}
+catch (...) {
+  retVal = ndbcINTERNAL_ERROR;
+}
+  return scope.Close(retVal);
+}
+
+/* ndbc custom function ndbcGroupCommit
+ * ndbcGroupCommit(connection, [interval])
+ * connection - A connection handle connected with SQLConnect.
+ * interval - The longest time in milliseconds a write waits for its group to be committed.
+ *            A positive interval turns group commit on, turning SQL_ATTR_AUTOCOMMIT off.
+ *            0 commits the open group, if any, and turns group commit off, turning SQL_ATTR_AUTOCOMMIT back on.
+ *            If omitted, the settings are left unchanged.
+ *
+ * In group commit mode, the writes made on the connection by any number of callers share one transaction, which is
+ * committed once per interval instead of once per write.  Each caller makes its writes as usual, then passes a
+ * callback to AwaitCommit, which is called once the transaction holding them has been committed.
+ * The interval starts with the first write to wait on the group, so an idle connection does not commit, and does
+ * not keep node running.
+ * A group that fails to commit is rolled back and each of its writes is called back with 'SQL_ERROR'.
+ * The open group can also be ended early with SQLEndTran on the connection handle.
+ * Turn group commit off before disconnecting, so the last group is committed.  Writes still waiting when the
+ * connection is freed are called back with 'SQL_ROLLBACK'.
+ *
+ * Returns the connection's group commit settings and counters as an object:
+ *   interval - The group commit interval in milliseconds, or 0 if group commit is off.
+ *   pending - The number of writes waiting for the open group to be committed.
+ *   commits - The number of groups committed.
+ *   writes - The number of writes committed in groups.
+ * If the settings could not be changed, returns a string describing the error instead.  Use typeof to determine
+ * success.
+ */
+Handle<Value> ndbcGroupCommit(const Arguments& args) {
+  HandleScope scope;
+  Local<Value> retVal;
+try {
+  SQLHANDLE connection = (SQLHANDLE) External::Unwrap(args[0]);
+  ndbcConnectionState* state;
+  Local<Object> stats;
+  SQLUINTEGER interval;
+  bool ok = true;
+
+  state = ndbcGetConnectionState(connection, true);
+  if (state == NULL) {
+    ok = false;
+    retVal = ndbcINTERNAL_ERROR;
+  } else if (args.Length() >= 2 && !args[1]->IsUndefined()) {
+    interval = args[1]->Uint32Value();
+    if (interval > 0 && state->groupTimer == NULL) {
+      switch (SQLSetConnectAttr(connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0)) {
       case SQL_ERROR:
-        retVal = ndbcSQL_ERROR;
         ok = false;
+        retVal = ndbcSQL_ERROR;
         break;
       case SQL_INVALID_HANDLE:
-        retVal = ndbcSQL_INVALID_HANDLE;
-        ok = false;
-        break;
-      case SQL_STILL_EXECUTING:
-        retVal = ndbcSQL_STILL_EXECUTING;
         ok = false;
-        break;
-      case SQL_NO_DATA:
-        // Return SQL_NO_DATA if no data has been read so far.
-        if (k > 0) {
-          data = false;
-        } else {
-          retVal = ndbcSQL_NO_DATA;
-          ok = false;
-        }
+        retVal = ndbcSQL_INVALID_HANDLE;
         break;
       default:
-        // Write a preceding comma and begin the row array.
-        recData[k] = ',';
-        k++;
-        recData[k] = '[';
-        k++;
-        // Write the data array to the output.
-        for (j = 0; j < columns; j++) {
-          // Check for nulls.
-          if (*rowInd[j] == SQL_NULL_DATA) {
-            recData[k] = 'n';
-            k++;
-            recData[k] = 'u';
-            k++;
-            recData[k] = 'l';
-            k++;
-            recData[k] = 'l';
-            k++;
-          } else {
-            switch (serialize[j]) {
-            case 'q':
-              recData[k] = '\"';
-              k++;
-              // Transcribe text data using escape sequences and discarding control characters.
-              for (l = 0; l < *rowInd[j]; l++) {
-                if (rowData[j][l] < 32 || (rowData[j][l] > 126 && rowData[j][l] < 160)) {
-                  // Map non-printable characters to spaces.
-                  recData[k] = ' ';
-                  k++;
-                } else if (rowData[j][l] == '\"' || rowData[j][l] == '\\') {
-                  // Apply escape sequence to " and \ characters.
-                  recData[k] = '\\';
-                  k++;
-                  recData[k] = rowData[j][l];
-                  k++;
-                } else {
-                  // Copy other data over verbatim.
-                  recData[k] = rowData[j][l];
-                  k++;
-                }
-              }
-              recData[k] = '\"';
-              k++;
-              break;
-            case 'b':
-              recData[k] = '\"';
-              k++;
-              // Transcribe binary data using base64 encoding.
-              recData[k] = '\"';
-              k++;
-              break;
-            case 'n':
-              // Transcribe numeric data verbatim.
-              for (l = 0; l < *rowInd[j]; l++) {
-                recData[k] = rowData[j][l];
-                k++;
-              }
-            }
-          }
-          recData[k] = ',';
-          k++;
+        state->groupTimer = (uv_timer_t*) malloc(sizeof(uv_timer_t));
+        if (state->groupTimer == NULL) {
+          SQLSetConnectAttr(connection, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, 0);
+          ok = false;
+          retVal = ndbcINTERNAL_ERROR;
+        } else {
+          uv_timer_init(uv_default_loop(), state->groupTimer);
+          state->groupTimer->data = state;
         }
-        // Overwrite the last comma and terminate the row array.
-        recData[k-1] = ']';
       }
     }
-    // Add null terminating character to output Json data.
-    recData[k] = 0;
+    if (interval > 0 && state->groupTimer != NULL) {
+      // A changed interval applies from the next group.
+      state->groupInterval = interval;
+    } else if (interval == 0 && state->groupTimer != NULL) {
+      if (ndbcCommitGroup(state, true) == SQL_ERROR) {
+        // The group was rolled back, and its writes told so.  Group commit is still turned off.
+        ok = false;
+        retVal = ndbcSQL_ERROR;
+      }
+      // The writes' callbacks may have turned group commit on again or freed the connection.
+      state = ndbcGetConnectionState(connection, false);
+      if (ok && state == NULL) {
+        ok = false;
+        retVal = ndbcSQL_INVALID_HANDLE;
+      }
+    }
   }
-  
+
   if (ok) {
-    // Copy the formatted data to the output.
-    retVal = String::New(recData, k);
-  }
-  // Free allocated memory resources.
-  for (j = 0; j < columns; j++) {
-    free(rowData[j]);
-    free(rowInd[j]);
+    stats = Object::New();
+    stats->Set(String::NewSymbol("interval"), Integer::NewFromUnsigned(state->groupInterval));
+    stats->Set(String::NewSymbol("pending"),
+               Integer::NewFromUnsigned(state->groupWaiters.IsEmpty() ? 0 : state->groupWaiters->Length()));
+    stats->Set(String::NewSymbol("commits"), Number::New(state->groupCommits));
+    stats->Set(String::NewSymbol("writes"), Number::New(state->groupWrites));
+    retVal = stats;
   }
-  free(rowData);
-  free(rowInd);
-  free(serialize);
-  free(recData);
-  free(rowLen);
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -6859,20 +13640,33 @@ catch (...) {
   return scope.Close(retVal);
 }
 
-/* ndbc custom function ndbcJsonTrailer
- * ndbcJsonTrailer(statement)
- * statement - An statement handle that has an available result set.
+/* ndbc custom function ndbcAwaitCommit
+ * ndbcAwaitCommit(connection, callback)
+ * connection - A connection handle in group commit mode (see GroupCommit).
+ * callback - A function called as callback(error) once the writes made so far on the connection are committed.
+ *            error is null if they were committed, or 'SQL_ERROR' or 'SQL_ROLLBACK' if they were rolled back.
  *
- * Returns a trailing ] character to begin the array of records.
- * Technically, the argument isn't required, but you can supply it if you like.
+ * Joins the writes just made to the connection's open group.  The group is committed within the connection's
+ * group commit interval of its first write.
+ * Returns the string 'SQL_SUCCESS' if it succeeds.
+ * Returns 'INVALID_ARGUMENT' if the connection is not in group commit mode.
  */
-Handle<Value> ndbcJsonTrailer(const Arguments& args) {
+Handle<Value> ndbcAwaitCommit(const Arguments& args) {
   HandleScope scope;
   Local<Value> retVal;
 try {
+  ndbcConnectionState* state = ndbcGetConnectionState((SQLHANDLE) External::Unwrap(args[0]), false);
 
-  retVal = String::New("]");
-  
+  if (state == NULL || state->groupTimer == NULL || !args[1]->IsFunction()) {
+    retVal = ndbcINVALID_ARGUMENT;
+  } else {
+    if (state->groupWaiters.IsEmpty()) {
+      state->groupWaiters = Persistent<Array>::New(Array::New());
+      uv_timer_start(state->groupTimer, ndbcGroupCommitTimer, state->groupInterval, 0);
+    }
+    state->groupWaiters->Set(state->groupWaiters->Length(), args[1]);
+    retVal = ndbcSQL_SUCCESS;
+  }
 }
 catch (...) {
   retVal = ndbcINTERNAL_ERROR;
@@ -6880,7 +13674,12 @@ catch (...) {
   return scope.Close(retVal);
 }
 
+
 void init(Handle<Object> target) {
+  ndbcRowDescClass = Persistent<FunctionTemplate>::New(FunctionTemplate::New());
+  ndbcRowDescClass->SetClassName(String::NewSymbol("ndbcRowDesc"));
+  ndbcRowDescClass->InstanceTemplate()->SetInternalFieldCount(1);
+
   target->Set(String::NewSymbol("SQLAllocHandle"),
               FunctionTemplate::New(ndbcSQLAllocHandle)->GetFunction());
   target->Set(String::NewSymbol("SQLFreeHandle"),
@@ -6905,16 +13704,68 @@ void init(Handle<Object> target) {
               FunctionTemplate::New(ndbcSQLGetStmtAttr)->GetFunction());
   target->Set(String::NewSymbol("SQLExecDirect"),
               FunctionTemplate::New(ndbcSQLExecDirect)->GetFunction());
+  target->Set(String::NewSymbol("SQLPrepare"),
+              FunctionTemplate::New(ndbcSQLPrepare)->GetFunction());
+  target->Set(String::NewSymbol("SQLExecute"),
+              FunctionTemplate::New(ndbcSQLExecute)->GetFunction());
+  target->Set(String::NewSymbol("SQLParamData"),
+              FunctionTemplate::New(ndbcSQLParamData)->GetFunction());
+  target->Set(String::NewSymbol("SQLPutData"),
+              FunctionTemplate::New(ndbcSQLPutData)->GetFunction());
+  target->Set(String::NewSymbol("SQLSetPos"),
+              FunctionTemplate::New(ndbcSQLSetPos)->GetFunction());
+  target->Set(String::NewSymbol("SQLBulkOperations"),
+              FunctionTemplate::New(ndbcSQLBulkOperations)->GetFunction());
   target->Set(String::NewSymbol("SQLRowCount"),
               FunctionTemplate::New(ndbcSQLRowCount)->GetFunction());
+  target->Set(String::NewSymbol("SQLMoreResults"),
+              FunctionTemplate::New(ndbcSQLMoreResults)->GetFunction());
+  target->Set(String::NewSymbol("SQLEndTran"),
+              FunctionTemplate::New(ndbcSQLEndTran)->GetFunction());
   target->Set(String::NewSymbol("JsonDescribe"),
               FunctionTemplate::New(ndbcJsonDescribe)->GetFunction());
+  target->Set(String::NewSymbol("JsonMetadata"),
+              FunctionTemplate::New(ndbcJsonMetadata)->GetFunction());
   target->Set(String::NewSymbol("JsonHeader"),
               FunctionTemplate::New(ndbcJsonHeader)->GetFunction());
   target->Set(String::NewSymbol("JsonData"),
               FunctionTemplate::New(ndbcJsonData)->GetFunction());
+  target->Set(String::NewSymbol("JsonDataBudget"),
+              FunctionTemplate::New(ndbcJsonDataBudget)->GetFunction());
+  target->Set(String::NewSymbol("JsonDataScroll"),
+              FunctionTemplate::New(ndbcJsonDataScroll)->GetFunction());
+  target->Set(String::NewSymbol("JsonColumnData"),
+              FunctionTemplate::New(ndbcJsonColumnData)->GetFunction());
   target->Set(String::NewSymbol("JsonTrailer"),
               FunctionTemplate::New(ndbcJsonTrailer)->GetFunction());
+  target->Set(String::NewSymbol("BindParameters"),
+              FunctionTemplate::New(ndbcBindParameters)->GetFunction());
+  target->Set(String::NewSymbol("BindDataAtExec"),
+              FunctionTemplate::New(ndbcBindDataAtExec)->GetFunction());
+  target->Set(String::NewSymbol("ExecBatch"),
+              FunctionTemplate::New(ndbcExecBatch)->GetFunction());
+  target->Set(String::NewSymbol("ExecColumns"),
+              FunctionTemplate::New(ndbcExecColumns)->GetFunction());
+  target->Set(String::NewSymbol("BindRowset"),
+              FunctionTemplate::New(ndbcBindRowset)->GetFunction());
+  target->Set(String::NewSymbol("RowStatus"),
+              FunctionTemplate::New(ndbcRowStatus)->GetFunction());
+  target->Set(String::NewSymbol("BulkWrite"),
+              FunctionTemplate::New(ndbcBulkWrite)->GetFunction());
+  target->Set(String::NewSymbol("StatementCache"),
+              FunctionTemplate::New(ndbcStatementCache)->GetFunction());
+  target->Set(String::NewSymbol("CachedExecute"),
+              FunctionTemplate::New(ndbcCachedExecute)->GetFunction());
+  target->Set(String::NewSymbol("BulkLoad"),
+              FunctionTemplate::New(ndbcBulkLoad)->GetFunction());
+  target->Set(String::NewSymbol("PutStream"),
+              FunctionTemplate::New(ndbcPutStream)->GetFunction());
+  target->Set(String::NewSymbol("GroupCommit"),
+              FunctionTemplate::New(ndbcGroupCommit)->GetFunction());
+  target->Set(String::NewSymbol("AwaitCommit"),
+              FunctionTemplate::New(ndbcAwaitCommit)->GetFunction());
+  target->Set(String::NewSymbol("CallProcedure"),
+              FunctionTemplate::New(ndbcCallProcedure)->GetFunction());
 }
 NODE_MODULE(ndbc, init)
 
@@ -6932,6 +13783,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_AD_CONSTRAINT_NAME_DEFINITION
 #undef ndbcSQL_AD_DROP_DOMAIN_CONSTRAINT
 #undef ndbcSQL_AD_DROP_DOMAIN_DEFAULT
+#undef ndbcSQL_ADD
 #undef ndbcSQL_AF_ALL
 #undef ndbcSQL_AF_AVG
 #undef ndbcSQL_AF_COUNT
@@ -7024,7 +13876,10 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_AUTOCOMMIT_ON
 #undef ndbcSQL_BATCH_ROW_COUNT
 #undef ndbcSQL_BATCH_SUPPORT
+#undef ndbcSQL_BIGINT
+#undef ndbcSQL_BINARY
 #undef ndbcSQL_BIND_BY_COLUMN
+#undef ndbcSQL_BIT
 #undef ndbcSQL_BOOKMARK_PERSISTENCE
 #undef ndbcSQL_BP_CLOSE
 #undef ndbcSQL_BP_DELETE
@@ -7105,6 +13960,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_CDO_CONSTRAINT_NON_DEFERRABLE
 #undef ndbcSQL_CDO_CREATE_DOMAIN
 #undef ndbcSQL_CDO_DEFAULT
+#undef ndbcSQL_CHAR
 #undef ndbcSQL_CL_END
 #undef ndbcSQL_CL_NOT_SUPPORTED
 #undef ndbcSQL_CL_START
@@ -7113,6 +13969,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_CN_NONE
 #undef ndbcSQL_COLLATION_SEQ
 #undef ndbcSQL_COLUMN_ALIAS
+#undef ndbcSQL_COMMIT
 #undef ndbcSQL_CONCAT_NULL_BEHAVIOR
 #undef ndbcSQL_CONCUR_LOCK
 #undef ndbcSQL_CONCUR_READ_ONLY
@@ -7228,7 +14085,10 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_DD_DROP_DOMAIN
 #undef ndbcSQL_DD_RESTRICT
 #undef ndbcSQL_DDL_INDEX
+#undef ndbcSQL_DECIMAL
 #undef ndbcSQL_DEFAULT_TXN_ISOLATION
+#undef ndbcSQL_DELETE
+#undef ndbcSQL_DELETE_BY_BOOKMARK
 #undef ndbcSQL_DESCRIBE_PARAMETER
 #undef ndbcSQL_DI_CREATE_INDEX
 #undef ndbcSQL_DI_DROP_INDEX
@@ -7249,6 +14109,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_DL_SQL92_TIME
 #undef ndbcSQL_DL_SQL92_TIMESTAMP
 #undef ndbcSQL_DM_VER
+#undef ndbcSQL_DOUBLE
 #undef ndbcSQL_DRIVER_HDBC
 #undef ndbcSQL_DRIVER_HDESC
 #undef ndbcSQL_DRIVER_HENV
@@ -7281,10 +14142,18 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_ERROR
 #undef ndbcSQL_EXPRESSIONS_IN_ORDERBY
 #undef ndbcSQL_FALSE
+#undef ndbcSQL_FETCH_ABSOLUTE
+#undef ndbcSQL_FETCH_BY_BOOKMARK
+#undef ndbcSQL_FETCH_FIRST
+#undef ndbcSQL_FETCH_LAST
+#undef ndbcSQL_FETCH_NEXT
+#undef ndbcSQL_FETCH_PRIOR
+#undef ndbcSQL_FETCH_RELATIVE
 #undef ndbcSQL_FILE_CATALOG
 #undef ndbcSQL_FILE_NOT_SUPPORTED
 #undef ndbcSQL_FILE_TABLE
 #undef ndbcSQL_FILE_USAGE
+#undef ndbcSQL_FLOAT
 #undef ndbcSQL_FN_CVT_CAST
 #undef ndbcSQL_FN_CVT_CONVERT
 #undef ndbcSQL_FN_NUM_ABS
@@ -7382,6 +14251,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_GD_OUTPUT_PARAMS
 #undef ndbcSQL_GETDATA_EXTENSIONS
 #undef ndbcSQL_GROUP_BY
+#undef ndbcSQL_GUID
 #undef ndbcSQL_HANDLE_DBC
 #undef ndbcSQL_HANDLE_DESC
 #undef ndbcSQL_HANDLE_ENV
@@ -7400,6 +14270,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_INFO_SCHEMA_VIEWS
 #undef ndbcSQL_INSENSITIVE
 #undef ndbcSQL_INSERT_STATEMENT
+#undef ndbcSQL_INTEGER
 #undef ndbcSQL_INTEGRITY
 #undef ndbcSQL_INVALID_HANDLE
 #undef ndbcSQL_IS_INSERT_LITERALS
@@ -7432,6 +14303,11 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_KEYSET_CURSOR_ATTRIBUTES2
 #undef ndbcSQL_KEYWORDS
 #undef ndbcSQL_LIKE_ESCAPE_CLAUSE
+#undef ndbcSQL_LOCK_EXCLUSIVE
+#undef ndbcSQL_LOCK_NO_CHANGE
+#undef ndbcSQL_LOCK_UNLOCK
+#undef ndbcSQL_LONGVARBINARY
+#undef ndbcSQL_LONGVARCHAR
 #undef ndbcSQL_MAX_ASYNC_CONCURRENT_STATEMENTS
 #undef ndbcSQL_MAX_BINARY_LITERAL_LEN
 #undef ndbcSQL_MAX_CATALOG_NAME_LEN
@@ -7473,6 +14349,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_NOSCAN_OFF
 #undef ndbcSQL_NOSCAN_ON
 #undef ndbcSQL_NULL_COLLATION
+#undef ndbcSQL_NUMERIC
 #undef ndbcSQL_NUMERIC_FUNCTIONS
 #undef ndbcSQL_ODBC_INTERFACE_CONFORMANCE
 #undef ndbcSQL_ODBC_VER
@@ -7500,6 +14377,9 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_PARAM_DIAG_UNAVAILABLE
 #undef ndbcSQL_PARAM_ERROR
 #undef ndbcSQL_PARAM_IGNORE
+#undef ndbcSQL_PARAM_INPUT
+#undef ndbcSQL_PARAM_INPUT_OUTPUT
+#undef ndbcSQL_PARAM_OUTPUT
 #undef ndbcSQL_PARAM_PROCEED
 #undef ndbcSQL_PARAM_SUCCESS
 #undef ndbcSQL_PARAM_SUCCESS_WITH_INFO
@@ -7515,13 +14395,24 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_POS_POSITION
 #undef ndbcSQL_POS_REFRESH
 #undef ndbcSQL_POS_UPDATE
+#undef ndbcSQL_POSITION
 #undef ndbcSQL_PROCEDURE_TERM
 #undef ndbcSQL_PROCEDURES
 #undef ndbcSQL_QUOTED_IDENTIFIER_CASE
 #undef ndbcSQL_RD_OFF
 #undef ndbcSQL_RD_ON
+#undef ndbcSQL_REAL
+#undef ndbcSQL_REFRESH
+#undef ndbcSQL_ROLLBACK
+#undef ndbcSQL_ROW_ADDED
+#undef ndbcSQL_ROW_DELETED
+#undef ndbcSQL_ROW_ERROR
 #undef ndbcSQL_ROW_IGNORE
+#undef ndbcSQL_ROW_NOROW
 #undef ndbcSQL_ROW_PROCEED
+#undef ndbcSQL_ROW_SUCCESS
+#undef ndbcSQL_ROW_SUCCESS_WITH_INFO
+#undef ndbcSQL_ROW_UPDATED
 #undef ndbcSQL_ROW_UPDATES
 #undef ndbcSQL_SC_FIPS127_2_TRANSITIONAL
 #undef ndbcSQL_SC_NON_UNIQUE
@@ -7563,6 +14454,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_SG_USAGE_ON_DOMAIN
 #undef ndbcSQL_SG_USAGE_ON_TRANSLATION
 #undef ndbcSQL_SG_WITH_GRANT_OPTION
+#undef ndbcSQL_SMALLINT
 #undef ndbcSQL_SNVF_BIT_LENGTH
 #undef ndbcSQL_SNVF_CHAR_LENGTH
 #undef ndbcSQL_SNVF_CHARACTER_LENGTH
@@ -7669,6 +14561,7 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_TIMEDATE_ADD_INTERVALS
 #undef ndbcSQL_TIMEDATE_DIFF_INTERVALS
 #undef ndbcSQL_TIMEDATE_FUNCTIONS
+#undef ndbcSQL_TINYINT
 #undef ndbcSQL_TRUE
 #undef ndbcSQL_TXN_CAPABLE
 #undef ndbcSQL_TXN_ISOLATION_OPTION
@@ -7676,17 +14569,43 @@ NODE_MODULE(ndbc, init)
 #undef ndbcSQL_TXN_READ_UNCOMMITTED
 #undef ndbcSQL_TXN_REPEATABLE_READ
 #undef ndbcSQL_TXN_SERIALIZABLE
+#undef ndbcSQL_TYPE_DATE
+#undef ndbcSQL_TYPE_TIME
+#undef ndbcSQL_TYPE_TIMESTAMP
 #undef ndbcSQL_U_UNION
 #undef ndbcSQL_U_UNION_ALL
 #undef ndbcSQL_UB_OFF
 #undef ndbcSQL_UB_VARIABLE
 #undef ndbcSQL_UNION
+#undef ndbcSQL_UNKNOWN_TYPE
 #undef ndbcSQL_UNSPECIFIED
+#undef ndbcSQL_UPDATE
+#undef ndbcSQL_UPDATE_BY_BOOKMARK
 #undef ndbcSQL_USER_NAME
+#undef ndbcSQL_VARBINARY
+#undef ndbcSQL_VARCHAR
+#undef ndbcSQL_WCHAR
+#undef ndbcSQL_WLONGVARCHAR
+#undef ndbcSQL_WVARCHAR
 #undef ndbcSQL_XOPEN_CLI_YEAR
 
 /* Undefine string representations of ndbc specific constants.
  */
 #undef ndbcINVALID_ARGUMENT
 #undef ndbcINVALID_RETURN
-#undef ndbcINTERNAL_ERROR
\ No newline at end of file
+#undef ndbcINTERNAL_ERROR
+
+/* Undefine string representations of ndbc option names and values.
+ */
+#undef ndbcCOLUMNS
+#undef ndbcDATETIME
+#undef ndbcDECIMAL
+#undef ndbcEPOCH
+#undef ndbcGUID
+#undef ndbcISO
+#undef ndbcNUMBER
+#undef ndbcPAIR
+#undef ndbcSCALED
+#undef ndbcSTRING
+#undef ndbcTEXT
+#undef ndbcLoadMaxErrors
\ No newline at end of file
@@ -54,8 +54,10 @@ retcode = ndbc.SQLExecDirect(stmt, 'SELECT * FROM NDBC_TEST.TEST_TABLE;');
 console.log('Output of SQLExecDirect: ' + retcode.toString());
 
 // Obtain a result set description from the completed statement.
+// The description is a native object; its rowDesc property shows it as text.
+// If JsonDescribe fails, it returns an error string instead.
 var desc = ndbc.JsonDescribe(stmt);
-console.log('Output of JsonDescribe: ' + desc.toString());
+console.log('Output of JsonDescribe: ' + (desc.rowDesc || desc).toString());
 
 // Start assembling the output by obtaining header data.
 var jsonOutput = ndbc.JsonHeader(stmt);